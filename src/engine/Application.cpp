@@ -125,6 +125,8 @@ void Application::Step() {
     }
 
     OnUpdate(deltaTime);
+    if (!IsRegistryBusy())
+      m_Commands.Apply(m_Registry);
 
     SDL_SetRenderDrawColor(m_Renderer, 0, 0, 0, 255);
     SDL_RenderClear(m_Renderer);
@@ -1,6 +1,9 @@
 #pragma once
 #include "Camera.h"
+#include "CommandBuffer.h"
 #include "ECS.h"
+#include "JobSystem.h"
+#include "Scheduler.h"
 #include <SDL2/SDL.h>
 #include <memory>
 
@@ -18,6 +21,9 @@ public:
   SDL_Renderer *GetRenderer() const { return m_Renderer; }
   Camera &GetCamera() { return *m_Camera; }
   Registry &GetRegistry() { return m_Registry; }
+  CommandBuffer &GetCommands() { return m_Commands; }
+  JobSystem &GetJobs() { return m_Jobs; }
+  Scheduler &GetScheduler() { return m_Scheduler; }
 
   int GetWindowWidth() const { return m_Width; }
   int GetWindowHeight() const { return m_Height; }
@@ -26,6 +32,9 @@ protected:
   virtual void OnStart() {}
   virtual void OnUpdate(float deltaTime) {}
   virtual void OnRender() {}
+  // True while a background job owns the registry; queued commands wait
+  // until it hands it back.
+  virtual bool IsRegistryBusy() const { return false; }
 
   SDL_Window *m_Window = nullptr;
   SDL_Renderer *m_Renderer = nullptr;
@@ -35,6 +44,9 @@ protected:
   bool m_IsRunning = false;
   std::unique_ptr<Camera> m_Camera;
   Registry m_Registry;
+  CommandBuffer m_Commands;
+  JobSystem m_Jobs;
+  Scheduler m_Scheduler{m_Registry, m_Jobs};
 };
 
 } // namespace PixelsEngine
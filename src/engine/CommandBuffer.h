@@ -0,0 +1,72 @@
+#pragma once
+#include "ECS.h"
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace PixelsEngine {
+
+// Records structural changes (create, destroy, add/remove component) while
+// systems iterate pools, and replays them in order at a sync point. Recording
+// is thread-safe so parallel systems can share one buffer.
+class CommandBuffer {
+public:
+  using CreateFunc = std::function<void(Registry &, Entity)>;
+
+  void Create(CreateFunc setup) {
+    Record([setup = std::move(setup)](Registry &registry) {
+      setup(registry, registry.CreateEntity());
+    });
+  }
+
+  void Destroy(Entity entity) {
+    Record([entity](Registry &registry) { registry.DestroyEntity(entity); });
+  }
+
+  template <typename T> void AddComponent(Entity entity, T component) {
+    Record([entity, component = std::move(component)](Registry &registry) {
+      registry.AddComponent(entity, component);
+    });
+  }
+
+  template <typename T> void RemoveComponent(Entity entity) {
+    Record([entity](Registry &registry) {
+      registry.RemoveComponent<T>(entity);
+    });
+  }
+
+  bool Empty() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Commands.empty();
+  }
+
+  // Drops everything recorded since the last Apply.
+  void Clear() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Commands.clear();
+  }
+
+  // Commands recorded while applying (e.g. from a Create setup) run in the
+  // next batch, not this one.
+  void Apply(Registry &registry) {
+    std::vector<std::function<void(Registry &)>> commands;
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      commands.swap(m_Commands);
+    }
+    for (auto &command : commands)
+      command(registry);
+  }
+
+private:
+  void Record(std::function<void(Registry &)> command) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Commands.push_back(std::move(command));
+  }
+
+  std::mutex m_Mutex;
+  std::vector<std::function<void(Registry &)>> m_Commands;
+};
+
+} // namespace PixelsEngine
@@ -85,6 +85,7 @@ struct AIComponent {
   float attackTimer = 0.0f;
   bool isAggressive = true;
   float hostileTimer = 0.0f; // Temporary hostility
+  float fleeTimer = 0.0f;    // Passive critters keep running after a scare
   // Cone of vision
   float facingDir = 0.0f;  // in degrees, 0 = East
   float coneAngle = 60.0f; // Total angle of the cone
@@ -94,11 +95,17 @@ struct LootComponent {
   std::vector<PixelsEngine::Item> drops;
 };
 
-enum class EntityTag { None, Hostile, NPC, Companion, Trader, Quest, CampProp };
-
-struct TagComponent {
-  EntityTag tag = EntityTag::None;
-};
+// Faction and role markers. These are ECS tags (Registry::AddTag), kept as
+// signature bits; an entity with none of them is passive wildlife.
+namespace Tags {
+struct Hostile {};
+struct NPC {};
+struct Companion {};
+struct Trader {};
+struct Quest {};
+struct CampProp {};
+struct Wildlife {};
+} // namespace Tags
 
 struct LockComponent {
   bool isLocked = true;
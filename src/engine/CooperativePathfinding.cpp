@@ -0,0 +1,194 @@
+#include "CooperativePathfinding.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+namespace PixelsEngine {
+
+void ReservationTable::Clear() {
+  m_Timed.clear();
+  m_Resting.clear();
+  m_TimedByAgent.clear();
+  m_RestingByAgent.clear();
+  m_LastTime = 0;
+}
+
+bool ReservationTable::Reserve(Entity agent, int tile, int time) {
+  auto result = m_Timed.emplace(Key(tile, time), agent);
+  if (!result.second)
+    return result.first->second == agent;
+  m_TimedByAgent[agent].push_back(Key(tile, time));
+  m_LastTime = std::max(m_LastTime, time);
+  return true;
+}
+
+void ReservationTable::ReserveFrom(Entity agent, int tile, int time) {
+  auto previous = m_RestingByAgent.find(agent);
+  if (previous != m_RestingByAgent.end()) {
+    m_Resting.erase(previous->second);
+    m_RestingByAgent.erase(previous);
+  }
+  m_Resting[tile] = {agent, time};
+  m_RestingByAgent[agent] = tile;
+}
+
+void ReservationTable::ReservePath(
+    Entity agent, const Tilemap &map, int startX, int startY,
+    const std::vector<std::pair<int, int>> &path) {
+  int width = map.GetWidth();
+  Reserve(agent, startY * width + startX, 0);
+  for (size_t i = 0; i < path.size(); ++i)
+    Reserve(agent, path[i].second * width + path[i].first, (int)i + 1);
+  auto last = path.empty() ? std::make_pair(startX, startY) : path.back();
+  ReserveFrom(agent, last.second * width + last.first, (int)path.size());
+}
+
+void ReservationTable::Release(Entity agent) {
+  auto timed = m_TimedByAgent.find(agent);
+  if (timed != m_TimedByAgent.end()) {
+    for (uint64_t key : timed->second)
+      m_Timed.erase(key);
+    m_TimedByAgent.erase(timed);
+  }
+  auto resting = m_RestingByAgent.find(agent);
+  if (resting != m_RestingByAgent.end()) {
+    m_Resting.erase(resting->second);
+    m_RestingByAgent.erase(resting);
+  }
+}
+
+Entity ReservationTable::GetHolder(int tile, int time) const {
+  auto timed = m_Timed.find(Key(tile, time));
+  if (timed != m_Timed.end())
+    return timed->second;
+  auto resting = m_Resting.find(tile);
+  if (resting != m_Resting.end() && resting->second.second <= time)
+    return resting->second.first;
+  return INVALID_ENTITY;
+}
+
+bool ReservationTable::CanMove(int from, int to, int time,
+                               Entity agent) const {
+  if (!IsFree(to, time + 1, agent))
+    return false;
+  if (from == to)
+    return true;
+  Entity oncoming = GetHolder(to, time);
+  return oncoming == INVALID_ENTITY || oncoming == agent ||
+         GetHolder(from, time + 1) != oncoming;
+}
+
+bool ReservationTable::IsFreeFrom(int tile, int time, Entity agent) const {
+  auto resting = m_Resting.find(tile);
+  if (resting != m_Resting.end() && resting->second.first != agent)
+    return false;
+  for (int t = time; t <= m_LastTime; ++t)
+    if (!IsFree(tile, t, agent))
+      return false;
+  return true;
+}
+
+namespace {
+struct SpaceTimeNode {
+  int tile;
+  int time;
+  float gCost;
+  int parent; // index into the node list, -1 for the start
+  bool closed;
+};
+} // namespace
+
+bool CooperativePathfinding::FindPath(
+    const Tilemap &map, const ReservationTable *reservations,
+    const OccupancyGrid *occupancy, Entity agent, int startX, int startY,
+    int endX, int endY, int stopDistance,
+    std::vector<std::pair<int, int>> &path, int horizon) {
+  static const int dx[] = {0, 0, 0, -1, 1, -1, -1, 1, 1}; // wait, then moves
+  static const int dy[] = {0, -1, 1, 0, 0, -1, 1, -1, 1};
+
+  path.clear();
+  int width = map.GetWidth();
+  if (startX < 0 || startY < 0 || startX >= width ||
+      startY >= map.GetHeight())
+    return false;
+
+  // Searches are short; the per-thread scratch just avoids reallocating.
+  thread_local std::vector<SpaceTimeNode> nodes;
+  thread_local std::unordered_map<uint64_t, int> index;
+  thread_local std::vector<PathfindingContext::HeapEntry> heap;
+  nodes.clear();
+  index.clear();
+  heap.clear();
+  auto greater = std::greater<PathfindingContext::HeapEntry>();
+  auto key = [](int tile, int time) {
+    return ((uint64_t)(uint32_t)time << 32) | (uint32_t)tile;
+  };
+  auto heuristic = [&](int x, int y) {
+    float h = Pathfinding::Heuristic(x, y, endX, endY) -
+              stopDistance * Pathfinding::DIAGONAL_COST;
+    return std::max(0.0f, h);
+  };
+  auto open = [&](int tile, int time, float gCost, int parent) {
+    auto found = index.find(key(tile, time));
+    int node;
+    if (found == index.end()) {
+      node = (int)nodes.size();
+      nodes.push_back({tile, time, gCost, parent, false});
+      index.emplace(key(tile, time), node);
+    } else {
+      node = found->second;
+      if (nodes[node].closed || gCost >= nodes[node].gCost)
+        return;
+      nodes[node].gCost = gCost;
+      nodes[node].parent = parent;
+    }
+    heap.push_back({gCost + heuristic(tile % width, tile / width), node});
+    std::push_heap(heap.begin(), heap.end(), greater);
+  };
+
+  open(startY * width + startX, 0, 0.0f, -1);
+  int expanded = 0;
+  while (!heap.empty() && expanded < Pathfinding::MAX_NODES) {
+    std::pop_heap(heap.begin(), heap.end(), greater);
+    int current = heap.back().tile;
+    heap.pop_back();
+    if (nodes[current].closed)
+      continue;
+    nodes[current].closed = true;
+    ++expanded;
+
+    SpaceTimeNode node = nodes[current];
+    int cx = node.tile % width;
+    int cy = node.tile / width;
+    bool arrived = std::max(std::abs(cx - endX), std::abs(cy - endY)) <=
+                   stopDistance;
+    if (arrived && (!reservations ||
+                    reservations->IsFreeFrom(node.tile, node.time, agent))) {
+      for (int n = current; nodes[n].parent != -1; n = nodes[n].parent)
+        path.push_back({nodes[n].tile % width, nodes[n].tile / width});
+      std::reverse(path.begin(), path.end());
+      return true;
+    }
+    if (node.time >= horizon)
+      continue;
+
+    for (int i = 0; i < 9; ++i) {
+      int nx = cx + dx[i];
+      int ny = cy + dy[i];
+      if (i > 0 && !map.IsWalkable(nx, ny))
+        continue;
+      if (i > 0 && occupancy && occupancy->IsOccupied(nx, ny, agent))
+        continue;
+      int tile = ny * width + nx;
+      if (reservations &&
+          !reservations->CanMove(node.tile, tile, node.time, agent))
+        continue;
+      float step = (i < 5) ? Pathfinding::STRAIGHT_COST
+                           : Pathfinding::DIAGONAL_COST;
+      open(tile, node.time + 1, node.gCost + step, current);
+    }
+  }
+  return false;
+}
+
+} // namespace PixelsEngine
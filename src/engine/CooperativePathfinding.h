@@ -0,0 +1,74 @@
+#pragma once
+#include "ECS.h"
+#include "OccupancyGrid.h"
+#include "Pathfinding.h"
+#include "Tilemap.h"
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PixelsEngine {
+
+// Space-time reservations for agents moving at the same time: who holds a
+// tile at each step, plus tiles held for good where a route ends. Times are
+// steps since the plans were made, so clear the table when re-planning.
+class ReservationTable {
+public:
+  void Clear();
+
+  // False (and nothing changes) when another agent already holds it.
+  bool Reserve(Entity agent, int tile, int time);
+  // Holds tile from time onwards; replaces the agent's previous hold.
+  void ReserveFrom(Entity agent, int tile, int time);
+  // A route in CooperativePathfinding::FindPath's format that starts on
+  // (startX, startY) at time 0; its last tile is held afterwards.
+  void ReservePath(Entity agent, const Tilemap &map, int startX, int startY,
+                   const std::vector<std::pair<int, int>> &path);
+  void Release(Entity agent);
+
+  Entity GetHolder(int tile, int time) const;
+  bool IsFree(int tile, int time, Entity agent) const {
+    Entity holder = GetHolder(tile, time);
+    return holder == INVALID_ENTITY || holder == agent;
+  }
+  // Stepping from -> to between time and time + 1: the target must be free
+  // on arrival and nobody may be crossing the other way.
+  bool CanMove(int from, int to, int time, Entity agent) const;
+  // Free at time and every step after, so the agent may stop there.
+  bool IsFreeFrom(int tile, int time, Entity agent) const;
+
+private:
+  static uint64_t Key(int tile, int time) {
+    return ((uint64_t)(uint32_t)time << 32) | (uint32_t)tile;
+  }
+
+  std::unordered_map<uint64_t, Entity> m_Timed;
+  std::unordered_map<int, std::pair<Entity, int>> m_Resting; // (agent, from)
+  std::unordered_map<Entity, std::vector<uint64_t>> m_TimedByAgent;
+  std::unordered_map<Entity, int> m_RestingByAgent;
+  int m_LastTime = 0; // latest timed reservation, bounds IsFreeFrom
+};
+
+// Cooperative A*: searches (tile, step) space so a route dodges both the
+// tiles other creatures stand on and the steps other agents reserved,
+// waiting in place when that is quicker than a detour. Agents plan one after
+// another, each reserving its result before the next searches.
+class CooperativePathfinding {
+public:
+  static constexpr int DEFAULT_HORIZON = 32;
+
+  // Route for agent to within stopDistance tiles (Chebyshev) of end, one
+  // entry per step with the start excluded; a repeated tile is a wait. Both
+  // occupancy and reservations may be null. Fails when no route fits in
+  // horizon steps or Pathfinding::MAX_NODES expansions.
+  static bool FindPath(const Tilemap &map,
+                       const ReservationTable *reservations,
+                       const OccupancyGrid *occupancy, Entity agent,
+                       int startX, int startY, int endX, int endY,
+                       int stopDistance,
+                       std::vector<std::pair<int, int>> &path,
+                       int horizon = DEFAULT_HORIZON);
+};
+
+} // namespace PixelsEngine
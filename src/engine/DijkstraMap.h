@@ -0,0 +1,140 @@
+#pragma once
+#include "Pathfinding.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace PixelsEngine {
+
+// Distance from every tile to the nearest of a set of goal tiles, over the
+// same 8-connected moves and costs as Pathfinding. Any number of agents
+// share one map and step downhill with an O(1) lookup each: toward the goal
+// on the plain map, away from it on the flee map derived from one.
+// Templated on the map like Pathfinding, so a worker can build it from a
+// WalkabilitySnapshot. Reading is const and thread-safe.
+class DijkstraMap {
+public:
+  // Scale for flee maps: negative to turn "near" into "high", and past -1 so
+  // a fleeing agent prefers a longer run toward open ground over a corner
+  // that is merely a little farther away.
+  static constexpr float FLEE_COEFFICIENT = -1.2f;
+
+  // Tiles costing more than maxCost from every source stay unreached.
+  template <typename Map>
+  void Build(const Map &map, const std::vector<std::pair<int, int>> &sources,
+             float maxCost = std::numeric_limits<float>::infinity()) {
+    Reset(map.GetWidth(), map.GetHeight());
+    for (auto &source : sources) {
+      if (!InBounds(source.first, source.second))
+        continue;
+      int tile = Index(source.first, source.second);
+      m_Value[tile] = 0.0f;
+      m_Heap.push_back({0.0f, tile});
+    }
+    std::make_heap(m_Heap.begin(), m_Heap.end(),
+                   std::greater<PathfindingContext::HeapEntry>());
+    Relax(map, maxCost);
+  }
+
+  // Inverts toward (a map built on the same tiles) and settles it again, so
+  // going downhill leads away from toward's goals, around walls rather than
+  // into dead ends.
+  template <typename Map>
+  void BuildFlee(const Map &map, const DijkstraMap &toward,
+                 float coefficient = FLEE_COEFFICIENT) {
+    Reset(toward.m_Width, toward.m_Height);
+    for (int tile = 0; tile < (int)m_Value.size(); ++tile) {
+      if (toward.m_Value[tile] == INFINITY_COST)
+        continue;
+      m_Value[tile] = toward.m_Value[tile] * coefficient;
+      m_Heap.push_back({m_Value[tile], tile});
+    }
+    std::make_heap(m_Heap.begin(), m_Heap.end(),
+                   std::greater<PathfindingContext::HeapEntry>());
+    Relax(map, std::numeric_limits<float>::infinity());
+  }
+
+  bool IsReached(int x, int y) const {
+    return InBounds(x, y) && m_Value[Index(x, y)] != INFINITY_COST;
+  }
+  // Infinity on unreached tiles.
+  float GetValue(int x, int y) const {
+    return InBounds(x, y) ? m_Value[Index(x, y)] : INFINITY_COST;
+  }
+  // Step to the lowest neighbour, if any is lower than (x, y) itself.
+  bool GetDownhill(int x, int y, int &dx, int &dy) const {
+    float best = GetValue(x, y);
+    bool found = false;
+    for (int i = 0; i < 8; ++i) {
+      float value = GetValue(x + STEP_X[i], y + STEP_Y[i]);
+      if (value < best) {
+        best = value;
+        dx = STEP_X[i];
+        dy = STEP_Y[i];
+        found = true;
+      }
+    }
+    return found;
+  }
+
+  int GetWidth() const { return m_Width; }
+  int GetHeight() const { return m_Height; }
+
+private:
+  static constexpr float INFINITY_COST = std::numeric_limits<float>::infinity();
+  // Same order as Pathfinding's A*: four straight moves, then diagonals.
+  static constexpr int STEP_X[] = {0, 0, -1, 1, -1, -1, 1, 1};
+  static constexpr int STEP_Y[] = {-1, 1, 0, 0, -1, 1, -1, 1};
+
+  bool InBounds(int x, int y) const {
+    return x >= 0 && y >= 0 && x < m_Width && y < m_Height;
+  }
+  int Index(int x, int y) const { return y * m_Width + x; }
+
+  void Reset(int width, int height) {
+    m_Width = width;
+    m_Height = height;
+    m_Value.assign((size_t)width * height, INFINITY_COST);
+    m_Heap.clear();
+  }
+
+  // Dijkstra from whatever values are seeded; seeds may be negative, since
+  // only the step costs need to be positive.
+  template <typename Map> void Relax(const Map &map, float maxCost) {
+    auto greater = std::greater<PathfindingContext::HeapEntry>();
+    while (!m_Heap.empty()) {
+      std::pop_heap(m_Heap.begin(), m_Heap.end(), greater);
+      PathfindingContext::HeapEntry top = m_Heap.back();
+      m_Heap.pop_back();
+      int current = top.tile;
+      if (top.fCost > m_Value[current])
+        continue;
+
+      int cx = current % m_Width;
+      int cy = current / m_Width;
+      for (int i = 0; i < 8; ++i) {
+        int nx = cx + STEP_X[i];
+        int ny = cy + STEP_Y[i];
+        if (!map.IsWalkable(nx, ny))
+          continue;
+        float value = m_Value[current] + (i < 4 ? Pathfinding::STRAIGHT_COST
+                                                : Pathfinding::DIAGONAL_COST);
+        int neighbor = Index(nx, ny);
+        if (value > maxCost || value >= m_Value[neighbor])
+          continue;
+        m_Value[neighbor] = value;
+        m_Heap.push_back({value, neighbor});
+        std::push_heap(m_Heap.begin(), m_Heap.end(), greater);
+      }
+    }
+  }
+
+  int m_Width = 0;
+  int m_Height = 0;
+  std::vector<float> m_Value;
+  std::vector<PathfindingContext::HeapEntry> m_Heap; // empty between builds
+};
+
+} // namespace PixelsEngine
@@ -0,0 +1,124 @@
+#include "DijkstraMapService.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace PixelsEngine {
+
+DijkstraMapService::~DijkstraMapService() {
+  for (auto &goal : m_Goals)
+    if (goal->building)
+      m_Jobs.Wait(goal->building->done);
+}
+
+DijkstraMapService::GoalId
+DijkstraMapService::AddGoal(float maxCost, int moveThreshold, bool withFlee) {
+  auto goal = std::make_unique<Goal>();
+  goal->maxCost = maxCost;
+  goal->moveThreshold = moveThreshold;
+  goal->withFlee = withFlee;
+  m_Goals.push_back(std::move(goal));
+  return (GoalId)m_Goals.size() - 1;
+}
+
+void DijkstraMapService::SetSources(
+    GoalId goal, const Tilemap &map,
+    const std::vector<std::pair<int, int>> &sources) {
+  Goal &entry = *m_Goals[goal];
+  entry.map = &map;
+  entry.sources = sources;
+  entry.sourcesSet = true;
+}
+
+void DijkstraMapService::Update() {
+  for (auto &goal : m_Goals) {
+    if (goal->building && goal->building->done.IsDone()) {
+      // The counter is touched once more after the job body returns.
+      m_Jobs.Wait(goal->building->done);
+      Build &build = *goal->building;
+      goal->installedMap = build.map;
+      goal->toward = std::make_unique<DijkstraMap>(std::move(build.toward));
+      if (goal->withFlee)
+        goal->flee = std::make_unique<DijkstraMap>(std::move(build.flee));
+      goal->building.reset();
+    }
+    if (!goal->building && NeedsBuild(*goal))
+      Start(*goal);
+  }
+}
+
+const DijkstraMap *DijkstraMapService::GetMap(GoalId goal,
+                                              const Tilemap &map) const {
+  const Goal &entry = *m_Goals[goal];
+  return entry.installedMap == &map ? entry.toward.get() : nullptr;
+}
+
+const DijkstraMap *DijkstraMapService::GetFleeMap(GoalId goal,
+                                                  const Tilemap &map) const {
+  const Goal &entry = *m_Goals[goal];
+  return entry.installedMap == &map ? entry.flee.get() : nullptr;
+}
+
+bool DijkstraMapService::NeedsBuild(Goal &goal) const {
+  if (!goal.map)
+    return false;
+  if (goal.builtMap != goal.map || goal.builtRevision != goal.map->GetRevision())
+    return true;
+  // Sources only need comparing after a SetSources; a rebuild takes them as
+  // built, so either way they are settled until the next one.
+  if (!goal.sourcesSet)
+    return false;
+  goal.sourcesSet = false;
+  return SourcesMoved(goal);
+}
+
+bool DijkstraMapService::SourcesMoved(const Goal &goal) const {
+  if (goal.sources.size() != goal.builtSources.size())
+    return true;
+  auto near = [&](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+    return std::max(std::abs(a.first - b.first),
+                    std::abs(a.second - b.second)) <= goal.moveThreshold;
+  };
+  // Usually the list comes back in the same order, so pair them up first.
+  size_t i = 0;
+  while (i < goal.sources.size() && near(goal.sources[i], goal.builtSources[i]))
+    ++i;
+  if (i == goal.sources.size())
+    return false;
+  // Otherwise match by distance, so a reordered list does not count as
+  // movement.
+  for (; i < goal.sources.size(); ++i) {
+    bool matched = false;
+    for (auto &built : goal.builtSources) {
+      if (near(goal.sources[i], built)) {
+        matched = true;
+        break;
+      }
+    }
+    if (!matched)
+      return true;
+  }
+  return false;
+}
+
+void DijkstraMapService::Start(Goal &goal) {
+  goal.builtMap = goal.map;
+  goal.builtRevision = goal.map->GetRevision();
+  goal.builtSources = goal.sources;
+
+  goal.building = std::make_unique<Build>();
+  Build *build = goal.building.get();
+  build->map = goal.map;
+  build->walkability = std::make_unique<WalkabilitySnapshot>(*goal.map);
+  build->sources = goal.sources;
+  float maxCost = goal.maxCost;
+  bool withFlee = goal.withFlee;
+  m_Jobs.RunBackground(
+      [build, maxCost, withFlee]() {
+        build->toward.Build(*build->walkability, build->sources, maxCost);
+        if (withFlee)
+          build->flee.BuildFlee(*build->walkability, build->toward);
+      },
+      &build->done);
+}
+
+} // namespace PixelsEngine
@@ -0,0 +1,87 @@
+#pragma once
+#include "DijkstraMap.h"
+#include "JobSystem.h"
+#include "Tilemap.h"
+#include "WalkabilitySnapshot.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace PixelsEngine {
+
+// Keeps one shared DijkstraMap (and optionally its flee map) per goal, such
+// as the player or the river. Goals get new sources every frame for free:
+// a rebuild only starts once a source has drifted more than the goal's
+// threshold from where the current map has it, or the map's walkability
+// changed. Rebuilds run on the job system against a WalkabilitySnapshot
+// while agents keep reading the previous maps, and are swapped in by a
+// later Update(). All calls are main thread only; the maps handed out may
+// be read from any thread until the next Update().
+class DijkstraMapService {
+public:
+  using GoalId = int;
+
+  explicit DijkstraMapService(JobSystem &jobs) : m_Jobs(jobs) {}
+  // Waits for builds still running on workers.
+  ~DijkstraMapService();
+
+  DijkstraMapService(const DijkstraMapService &) = delete;
+  DijkstraMapService &operator=(const DijkstraMapService &) = delete;
+
+  // maxCost bounds each build to a disc around the sources; moveThreshold is
+  // in tiles (Chebyshev); withFlee also derives the flee map.
+  GoalId AddGoal(float maxCost = std::numeric_limits<float>::infinity(),
+                 int moveThreshold = 0, bool withFlee = false);
+
+  void SetSources(GoalId goal, const Tilemap &map,
+                  const std::vector<std::pair<int, int>> &sources);
+  void SetSource(GoalId goal, const Tilemap &map, int x, int y) {
+    m_Single.assign(1, {x, y});
+    SetSources(goal, map, m_Single);
+  }
+
+  // Installs finished builds, then starts any the goals now need.
+  void Update();
+
+  // Null until the goal's first build lands, or for a map it was not set on.
+  const DijkstraMap *GetMap(GoalId goal, const Tilemap &map) const;
+  const DijkstraMap *GetFleeMap(GoalId goal, const Tilemap &map) const;
+
+private:
+  struct Build {
+    const Tilemap *map;
+    std::unique_ptr<const WalkabilitySnapshot> walkability;
+    std::vector<std::pair<int, int>> sources;
+    DijkstraMap toward;
+    DijkstraMap flee;
+    JobCounter done;
+  };
+  struct Goal {
+    float maxCost;
+    int moveThreshold;
+    bool withFlee;
+    const Tilemap *map = nullptr;
+    std::vector<std::pair<int, int>> sources; // latest, as set
+    bool sourcesSet = false; // since NeedsBuild last compared them
+    // What the newest map (installed or still building) was made from
+    const Tilemap *builtMap = nullptr;
+    uint32_t builtRevision = 0;
+    std::vector<std::pair<int, int>> builtSources;
+    const Tilemap *installedMap = nullptr; // what toward and flee cover
+    std::unique_ptr<DijkstraMap> toward;
+    std::unique_ptr<DijkstraMap> flee;
+    std::unique_ptr<Build> building;
+  };
+
+  bool NeedsBuild(Goal &goal) const;
+  bool SourcesMoved(const Goal &goal) const;
+  void Start(Goal &goal);
+
+  JobSystem &m_Jobs;
+  std::vector<std::unique_ptr<Goal>> m_Goals;
+  std::vector<std::pair<int, int>> m_Single;
+};
+
+} // namespace PixelsEngine
@@ -1,100 +1,948 @@
 #pragma once
 #include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <functional>
 #include <memory>
-#include <typeindex>
-#include <unordered_map>
-#include <unordered_set>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace PixelsEngine {
 
+// Handles pack a slot index in the low bits and a generation in the high
+// bits. Destroying an entity bumps its slot's generation and recycles the
+// index, so stale handles fail Valid() instead of aliasing the new owner.
 using Entity = uint32_t;
 const Entity INVALID_ENTITY = 0xFFFFFFFF;
 
+constexpr uint32_t ENTITY_INDEX_BITS = 20;
+constexpr uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr uint32_t ENTITY_GENERATION_MASK = 0xFFFFFFFF >> ENTITY_INDEX_BITS;
+
+inline uint32_t EntityIndex(Entity entity) { return entity & ENTITY_INDEX_MASK; }
+inline uint32_t EntityGeneration(Entity entity) {
+  return entity >> ENTITY_INDEX_BITS;
+}
+inline Entity MakeEntity(uint32_t index, uint32_t generation) {
+  return (generation << ENTITY_INDEX_BITS) | index;
+}
+
+// Listeners called with the entity whose component was constructed,
+// updated or is about to be destroyed.
+class Signal {
+public:
+  using Listener = std::function<void(Entity)>;
+
+  size_t Connect(Listener listener) {
+    m_Listeners.emplace_back(m_NextId, std::move(listener));
+    return m_NextId++;
+  }
+
+  void Disconnect(size_t id) {
+    m_Listeners.erase(std::remove_if(m_Listeners.begin(), m_Listeners.end(),
+                                     [id](const auto &entry) {
+                                       return entry.first == id;
+                                     }),
+                      m_Listeners.end());
+  }
+
+  void Publish(Entity entity) const {
+    for (size_t i = 0; i < m_Listeners.size(); ++i)
+      m_Listeners[i].second(entity);
+  }
+
+  bool Empty() const { return m_Listeners.empty(); }
+
+private:
+  std::vector<std::pair<size_t, Listener>> m_Listeners;
+  size_t m_NextId = 0;
+};
+
+// Backing arrays of a pool. Snapshots share a pool's storage until the pool
+// next writes to it, at which point the snapshot is handed a private copy.
+struct PoolStorage {
+  virtual ~PoolStorage() = default;
+  virtual std::shared_ptr<PoolStorage> Clone() const = 0;
+  virtual std::shared_ptr<PoolStorage> CloneEmpty() const = 0;
+
+  std::vector<uint32_t> sparse;
+  std::vector<Entity> dense;
+};
+
+// What snapshots hold of a pool. The pool redirects it to a copy when it
+// detaches, so the live storage (and every pointer into it) never moves.
+struct SharedPoolStorage {
+  std::shared_ptr<PoolStorage> storage;
+};
+
+template <typename T> struct TPoolStorage : PoolStorage {
+  std::shared_ptr<PoolStorage> Clone() const override {
+    return std::make_shared<TPoolStorage>(*this);
+  }
+  std::shared_ptr<PoolStorage> CloneEmpty() const override {
+    return std::make_shared<TPoolStorage>();
+  }
+
+  std::vector<T> components;
+};
+
+// Sparse set shared by every pool: dense packs the entities that own a
+// component and sparse maps an entity index to its slot in that array.
+// Removal swaps the last element into the hole, so order is not stable.
+//
+// With tracking enabled the pool also lists the entities whose component was
+// added or patched since the last ClearChanges(). Removed entities drop out
+// of both lists.
 class ComponentPool {
 public:
+  static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
   virtual ~ComponentPool() = default;
   virtual void Remove(Entity entity) = 0;
+
+  // Reorders the pool so that slot i holds what slot order[i] held.
+  virtual void Arrange(const std::vector<uint32_t> &order) = 0;
+
+  // Puts entities shared with other first, in other's order, followed by the
+  // rest in their current order. Used to keep pools that are iterated
+  // together in step after one of them has been sorted.
+  void SortAs(const ComponentPool &other) {
+    const std::vector<Entity> &dense = Read().dense;
+    std::vector<uint32_t> order;
+    order.reserve(dense.size());
+    for (Entity entity : other.Entities()) {
+      if (Has(entity))
+        order.push_back(Slot(entity));
+    }
+    for (uint32_t i = 0; i < dense.size() && order.size() < dense.size(); ++i) {
+      if (!other.Has(dense[i]))
+        order.push_back(i);
+    }
+    Arrange(order);
+  }
+
+  void EnableTracking(bool enabled) {
+    m_Tracking = enabled;
+    if (!enabled)
+      ClearChanges();
+  }
+  bool IsTracking() const { return m_Tracking; }
+
+  void NotifyConstruct(Entity entity) {
+    if (m_Tracking)
+      Mark(entity, ADDED, m_Added);
+    m_OnConstruct.Publish(entity);
+  }
+
+  void NotifyUpdate(Entity entity) {
+    if (m_Tracking)
+      Mark(entity, UPDATED, m_Updated);
+    m_OnUpdate.Publish(entity);
+  }
+
+  void NotifyDestroy(Entity entity) { m_OnDestroy.Publish(entity); }
+
+  bool IsAdded(Entity entity) const {
+    return Has(entity) && (m_Flags[Slot(entity)] & ADDED);
+  }
+  bool IsUpdated(Entity entity) const {
+    return Has(entity) && (m_Flags[Slot(entity)] & UPDATED);
+  }
+  const std::vector<Entity> &Added() const { return m_Added; }
+  const std::vector<Entity> &Updated() const { return m_Updated; }
+
+  void ClearChanges() {
+    for (Entity entity : m_Added)
+      m_Flags[Slot(entity)] = 0;
+    for (Entity entity : m_Updated)
+      m_Flags[Slot(entity)] = 0;
+    m_Added.clear();
+    m_Updated.clear();
+  }
+
+  Signal &OnConstruct() { return m_OnConstruct; }
+  Signal &OnUpdate() { return m_OnUpdate; }
+  Signal &OnDestroy() { return m_OnDestroy; }
+
+  bool Has(Entity entity) const {
+    const PoolStorage &data = Read();
+    uint32_t index = EntityIndex(entity);
+    return index < data.sparse.size() && data.sparse[index] != INVALID_INDEX &&
+           data.dense[data.sparse[index]] == entity;
+  }
+
+  size_t size() const { return Read().dense.size(); }
+  bool empty() const { return Read().dense.empty(); }
+  const std::vector<Entity> &Entities() const { return Read().dense; }
+
+  // Hands the current storage to a snapshot; the next write copies it out
+  // from under the snapshot.
+  std::shared_ptr<SharedPoolStorage> Share() {
+    std::lock_guard<std::mutex> lock(m_DetachMutex);
+    if (!m_SharedWith) {
+      m_SharedWith = std::make_shared<SharedPoolStorage>();
+      m_SharedWith->storage = m_Storage;
+    }
+    m_Shared.store(true, std::memory_order_release);
+    return m_SharedWith;
+  }
+
+  // Adopts a snapshot's storage (or empties the pool when there is none).
+  // Change lists are reset and no signals fire. Storage another registry
+  // already adopted is copied here, so no storage is ever live in two pools
+  // and a pool only swaps its storage out in Restore.
+  void Restore(const std::shared_ptr<SharedPoolStorage> &shared) {
+    std::lock_guard<std::mutex> lock(m_DetachMutex);
+    m_SharedWith.reset();
+    if (!shared) {
+      m_Storage = m_Storage->CloneEmpty();
+    } else if (shared->storage != m_Storage &&
+               shared->storage.use_count() > 1) {
+      m_Storage = shared->storage->Clone();
+    } else {
+      m_Storage = shared->storage;
+      m_SharedWith = shared;
+    }
+    m_Shared.store(m_SharedWith != nullptr, std::memory_order_release);
+    m_Flags.assign(m_Storage->dense.size(), 0);
+    m_Added.clear();
+    m_Updated.clear();
+  }
+
+protected:
+  explicit ComponentPool(std::shared_ptr<PoolStorage> storage)
+      : m_Storage(std::move(storage)) {}
+
+  // Reads never copy: the storage stays put until Restore, and snapshots
+  // only ever read it.
+  const PoolStorage &Read() const { return *m_Storage; }
+
+  // Every mutable access goes through here so that a pool shared with a
+  // snapshot is copied exactly once, even when parallel systems reach it
+  // together. The pool keeps its storage and the snapshot gets the copy.
+  PoolStorage &Data() {
+    if (m_Shared.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> lock(m_DetachMutex);
+      if (m_Shared.load(std::memory_order_relaxed)) {
+        if (m_SharedWith.use_count() > 1 && m_SharedWith->storage == m_Storage)
+          m_SharedWith->storage = m_Storage->Clone();
+        m_SharedWith.reset();
+        m_Shared.store(false, std::memory_order_release);
+      }
+    }
+    return *m_Storage;
+  }
+
+  void ReserveSlots(size_t capacity) {
+    Data().dense.reserve(capacity);
+    m_Flags.reserve(capacity);
+  }
+
+  uint32_t Insert(Entity entity) {
+    PoolStorage &data = Data();
+    uint32_t index = EntityIndex(entity);
+    if (index >= data.sparse.size())
+      data.sparse.resize(index + 1, INVALID_INDEX);
+    data.sparse[index] = (uint32_t)data.dense.size();
+    data.dense.push_back(entity);
+    m_Flags.push_back(0);
+    return data.sparse[index];
+  }
+
+  uint32_t Slot(Entity entity) const {
+    return Read().sparse[EntityIndex(entity)];
+  }
+
+  void ArrangeSlots(const std::vector<uint32_t> &order) {
+    PoolStorage &data = Data();
+    std::vector<Entity> dense(order.size());
+    std::vector<uint8_t> flags(order.size());
+    for (uint32_t i = 0; i < order.size(); ++i) {
+      dense[i] = data.dense[order[i]];
+      flags[i] = m_Flags[order[i]];
+      data.sparse[EntityIndex(dense[i])] = i;
+    }
+    data.dense.swap(dense);
+    m_Flags.swap(flags);
+  }
+
+  // Returns the slot the last element was moved out of.
+  uint32_t Erase(Entity entity, uint32_t &index) {
+    PoolStorage &data = Data();
+    index = Slot(entity);
+    if (m_Flags[index] & ADDED)
+      Unlist(entity, m_Added);
+    if (m_Flags[index] & UPDATED)
+      Unlist(entity, m_Updated);
+    uint32_t last = (uint32_t)data.dense.size() - 1;
+    data.dense[index] = data.dense[last];
+    m_Flags[index] = m_Flags[last];
+    data.sparse[EntityIndex(data.dense[index])] = index;
+    data.dense.pop_back();
+    m_Flags.pop_back();
+    data.sparse[EntityIndex(entity)] = INVALID_INDEX;
+    return last;
+  }
+
+private:
+  static constexpr uint8_t ADDED = 1;
+  static constexpr uint8_t UPDATED = 2;
+
+  void Mark(Entity entity, uint8_t flag, std::vector<Entity> &list) {
+    uint8_t &flags = m_Flags[Slot(entity)];
+    if (flags & flag)
+      return;
+    flags |= flag;
+    list.push_back(entity);
+  }
+
+  static void Unlist(Entity entity, std::vector<Entity> &list) {
+    auto it = std::find(list.begin(), list.end(), entity);
+    if (it != list.end()) {
+      *it = list.back();
+      list.pop_back();
+    }
+  }
+
+  std::shared_ptr<PoolStorage> m_Storage;
+  std::shared_ptr<SharedPoolStorage> m_SharedWith; // until detached
+  std::atomic<bool> m_Shared{false};
+  std::mutex m_DetachMutex;
+
+  std::vector<uint8_t> m_Flags; // ADDED/UPDATED bits, parallel to dense
+  std::vector<Entity> m_Added;
+  std::vector<Entity> m_Updated;
+  bool m_Tracking = false;
+  Signal m_OnConstruct;
+  Signal m_OnUpdate;
+  Signal m_OnDestroy;
 };
 
 template <typename T> class TCompPool : public ComponentPool {
 public:
-  void Remove(Entity entity) override { m_Components.erase(entity); }
+  class Iterator {
+  public:
+    Iterator(TPoolStorage<T> *data, size_t index)
+        : m_Data(data), m_Index(index) {}
+
+    std::pair<Entity, T &> operator*() const {
+      return {m_Data->dense[m_Index], m_Data->components[m_Index]};
+    }
+    Iterator &operator++() {
+      ++m_Index;
+      return *this;
+    }
+    bool operator==(const Iterator &other) const {
+      return m_Index == other.m_Index;
+    }
+    bool operator!=(const Iterator &other) const {
+      return m_Index != other.m_Index;
+    }
+
+  private:
+    TPoolStorage<T> *m_Data;
+    size_t m_Index;
+  };
+
+  TCompPool() : ComponentPool(std::make_shared<TPoolStorage<T>>()) {}
+
+  void Remove(Entity entity) override {
+    if (!Has(entity))
+      return;
+    std::vector<T> &components = Typed().components;
+    uint32_t index;
+    uint32_t last = Erase(entity, index);
+    if (index != last)
+      components[index] = std::move(components[last]);
+    components.pop_back();
+  }
+
+  void Arrange(const std::vector<uint32_t> &order) override {
+    std::vector<T> &components = Typed().components;
+    std::vector<T> arranged;
+    arranged.reserve(order.size());
+    for (uint32_t slot : order)
+      arranged.push_back(std::move(components[slot]));
+    components.swap(arranged);
+    ArrangeSlots(order);
+  }
+
+  // Stable sort of the dense arrays by compare(const T &, const T &).
+  template <typename Compare> void Sort(Compare compare) {
+    std::vector<T> &components = Typed().components;
+    std::vector<uint32_t> order(components.size());
+    for (uint32_t i = 0; i < order.size(); ++i)
+      order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+      return compare(components[a], components[b]);
+    });
+    Arrange(order);
+  }
 
   T &Add(Entity entity, T component) {
-    m_Components[entity] = component;
-    return m_Components[entity];
+    std::vector<T> &components = Typed().components;
+    if (Has(entity)) {
+      T &existing = components[Slot(entity)];
+      existing = std::move(component);
+      return existing;
+    }
+    Insert(entity);
+    components.push_back(std::move(component));
+    return components.back();
+  }
+
+  void Reserve(size_t capacity) {
+    ReserveSlots(capacity);
+    Typed().components.reserve(capacity);
   }
 
   T *Get(Entity entity) {
-    if (m_Components.find(entity) != m_Components.end()) {
-      return &m_Components[entity];
+    if (!Has(entity))
+      return nullptr;
+    return &Typed().components[Slot(entity)];
+  }
+
+  // Caller guarantees Has(entity).
+  T &GetUnchecked(Entity entity) { return Typed().components[Slot(entity)]; }
+
+  Iterator begin() { return Iterator(&Typed(), 0); }
+  Iterator end() {
+    TPoolStorage<T> &data = Typed();
+    return Iterator(&data, data.dense.size());
+  }
+
+  // Walks the pool back to front so the callback may remove the current
+  // entity without skipping the one swapped into its slot.
+  template <typename Func> void each(Func func) {
+    TPoolStorage<T> &data = Typed();
+    for (size_t i = data.dense.size(); i-- > 0;) {
+      if (i >= data.dense.size())
+        continue;
+      func(data.dense[i], data.components[i]);
+    }
+  }
+
+  std::vector<T> &Components() { return Typed().components; }
+
+private:
+  TPoolStorage<T> &Typed() {
+    return static_cast<TPoolStorage<T> &>(Data());
+  }
+};
+
+// Dense per-type IDs handed out the first time each component type is used.
+// Pools are stored in a vector indexed by this ID.
+using ComponentTypeId = uint32_t;
+
+inline ComponentTypeId NextComponentTypeId() {
+  static std::atomic<ComponentTypeId> next{0};
+  return next++;
+}
+
+template <typename T> ComponentTypeId ComponentType() {
+  static const ComponentTypeId id = NextComponentTypeId();
+  return id;
+}
+
+// One bit per component type, kept per entity slot by the Registry.
+constexpr size_t MAX_COMPONENTS = 64;
+using Signature = std::bitset<MAX_COMPONENTS>;
+
+template <typename... Ts> Signature MakeSignature() {
+  Signature signature;
+  (signature.set(ComponentType<Ts>()), ...);
+  return signature;
+}
+
+// Tags are empty structs. They have no pool; an entity's tags are just bits
+// in its signature, so filtering on them costs one mask test.
+template <typename T> constexpr bool IsTag = std::is_empty<T>::value;
+
+template <typename... Ts> struct Exclude {};
+template <typename... Ts> using Without = Exclude<Ts...>;
+
+// Extra components or tags an entity must have without being passed to the
+// view callback.
+template <typename... Ts> struct With {};
+
+// Joins several pools: walks the smallest one and tests each candidate's
+// signature against the included and excluded component masks.
+template <typename ExcludeList, typename... Ts> class TView;
+
+template <typename... Xs, typename... Ts> class TView<Exclude<Xs...>, Ts...> {
+public:
+  TView(const std::vector<Signature> &signatures, const Signature &with,
+        TCompPool<Ts> *...pools)
+      : m_Signatures(signatures), m_Pools(pools...),
+        m_Include(MakeSignature<Ts...>() | with),
+        m_Exclude(MakeSignature<Xs...>()) {}
+
+  template <typename Func> void each(Func func) {
+    const ComponentPool *lead = nullptr;
+    std::apply(
+        [&](auto *...pool) {
+          ((lead = (!lead || pool->size() < lead->size()) ? pool : lead), ...);
+        },
+        m_Pools);
+
+    const std::vector<Entity> &entities = lead->Entities();
+    for (size_t i = entities.size(); i-- > 0;) {
+      if (i >= entities.size())
+        continue;
+      Entity entity = entities[i];
+      if (!Contains(entity))
+        continue;
+      std::apply(
+          [&](auto *...pool) { func(entity, pool->GetUnchecked(entity)...); },
+          m_Pools);
+    }
+  }
+
+  // Only meaningful for live entities; views iterate pool members, which
+  // always are.
+  bool Contains(Entity entity) const {
+    const Signature &signature = m_Signatures[EntityIndex(entity)];
+    return (signature & m_Include) == m_Include && (signature & m_Exclude).none();
+  }
+
+private:
+  const std::vector<Signature> &m_Signatures;
+  std::tuple<TCompPool<Ts> *...> m_Pools;
+  Signature m_Include;
+  Signature m_Exclude;
+};
+
+class Registry;
+
+// Precomputed component bundle for spawning many identical entities. Build
+// it once (texture lookups, animation tables, loot lists) and hand it to
+// Registry::Instantiate, which copies every component straight into
+// pre-reserved pools.
+class Prefab {
+public:
+  template <typename T> Prefab &Set(T component) {
+    ComponentTypeId id = ComponentType<T>();
+    for (auto &entry : m_Entries) {
+      if (entry->id == id) {
+        static_cast<TEntry<T> &>(*entry).component = std::move(component);
+        return *this;
+      }
+    }
+    m_Entries.push_back(std::make_unique<TEntry<T>>(id, std::move(component)));
+    m_Signature.set(id);
+    return *this;
+  }
+
+  template <typename T> T *Get() {
+    ComponentTypeId id = ComponentType<T>();
+    for (auto &entry : m_Entries) {
+      if (entry->id == id)
+        return &static_cast<TEntry<T> &>(*entry).component;
     }
     return nullptr;
   }
 
-  bool Has(Entity entity) const {
-    return m_Components.find(entity) != m_Components.end();
+  template <typename T> Prefab &Tag() {
+    static_assert(IsTag<T>, "tags must be empty structs");
+    m_Signature.set(ComponentType<T>());
+    return *this;
   }
 
-  std::unordered_map<Entity, T> &GetAll() { return m_Components; }
+  const Signature &GetSignature() const { return m_Signature; }
+  bool Empty() const { return m_Signature.none(); }
 
 private:
-  std::unordered_map<Entity, T> m_Components;
+  friend class Registry;
+
+  struct Entry {
+    explicit Entry(ComponentTypeId id) : id(id) {}
+    virtual ~Entry() = default;
+    virtual void Populate(Registry &registry,
+                          const std::vector<Entity> &entities) const = 0;
+    ComponentTypeId id;
+  };
+
+  template <typename T> struct TEntry : Entry {
+    TEntry(ComponentTypeId id, T component)
+        : Entry(id), component(std::move(component)) {}
+    void Populate(Registry &registry,
+                  const std::vector<Entity> &entities) const override;
+    T component;
+  };
+
+  std::vector<std::unique_ptr<Entry>> m_Entries;
+  Signature m_Signature;
+};
+
+// Frozen copy of a registry's entities and components. Pools are shared with
+// the registry rather than copied; the first time the registry hands out
+// mutable access to a pool again (adding, removing, sorting, GetComponent,
+// iterating a view) the snapshot is given its own copy. Queries like
+// HasComponent never copy, so taking a snapshot is cheap, only pools that
+// may have changed cost memory, and component pointers fetched before the
+// snapshot stay valid. Components are copied by value, so
+// anything they hold through pointers stays shared.
+class RegistrySnapshot {
+public:
+  bool Empty() const { return m_Entities.empty(); }
+
+private:
+  friend class Registry;
+  std::vector<Entity> m_Entities;
+  std::vector<bool> m_Alive;
+  std::vector<uint32_t> m_FreeList;
+  std::vector<Signature> m_Signatures;
+  std::vector<std::shared_ptr<SharedPoolStorage>> m_Pools; // by type id
 };
 
 class Registry {
 public:
   Entity CreateEntity() {
-    Entity entity = m_NextEntity++;
-    m_Entities.insert(entity);
-    return entity;
+    if (!m_FreeList.empty()) {
+      uint32_t index = m_FreeList.back();
+      m_FreeList.pop_back();
+      m_Alive[index] = true;
+      return m_Entities[index];
+    }
+    uint32_t index = (uint32_t)m_Entities.size();
+    m_Entities.push_back(MakeEntity(index, 0));
+    m_Alive.push_back(true);
+    m_GenerationFloor.push_back(0);
+    m_Signatures.emplace_back();
+    return m_Entities.back();
   }
 
+  // Only the pools named in the entity's signature are touched.
   void DestroyEntity(Entity entity) {
-    m_Entities.erase(entity);
-    for (auto &pair : m_ComponentPools) {
-      pair.second->Remove(entity);
+    if (!Valid(entity))
+      return;
+    uint32_t index = EntityIndex(entity);
+    Signature &signature = m_Signatures[index];
+    for (size_t id = 0; id < m_ComponentPools.size() && signature.any(); ++id) {
+      if (signature.test(id) && m_ComponentPools[id]) {
+        m_ComponentPools[id]->NotifyDestroy(entity);
+        m_ComponentPools[id]->Remove(entity);
+        signature.reset(id);
+      }
     }
+    signature.reset(); // tags
+    uint32_t generation =
+        std::max(NextGeneration(entity), m_GenerationFloor[index]);
+    m_Entities[index] = MakeEntity(index, generation);
+    m_Alive[index] = false;
+    m_FreeList.push_back(index);
   }
 
   bool Valid(Entity entity) const {
-    return m_Entities.find(entity) != m_Entities.end();
+    uint32_t index = EntityIndex(entity);
+    return index < m_Entities.size() && m_Alive[index] &&
+           m_Entities[index] == entity;
+  }
+
+  // Re-adding an existing component replaces it and counts as an update.
+  // Returns nullptr for a destroyed or stale handle, which would otherwise
+  // write onto whoever owns its slot now.
+  template <typename T> T *AddComponent(Entity entity, T component) {
+    static_assert(!IsTag<T>, "use AddTag for empty structs");
+    if (!Valid(entity))
+      return nullptr;
+    TCompPool<T> *pool = GetPool<T>();
+    bool existed = pool->Has(entity);
+    m_Signatures[EntityIndex(entity)].set(ComponentType<T>());
+    T &added = pool->Add(entity, std::move(component));
+    if (existed)
+      pool->NotifyUpdate(entity);
+    else
+      pool->NotifyConstruct(entity);
+    return &added;
   }
 
-  template <typename T> T &AddComponent(Entity entity, T component) {
-    return GetPool<T>()->Add(entity, component);
+  // Applies each func to the component, then marks it updated and fires
+  // OnUpdate. With no funcs it just records a change made in place.
+  template <typename T, typename... Funcs>
+  T *Patch(Entity entity, Funcs &&...funcs) {
+    if (!HasComponent<T>(entity))
+      return nullptr;
+    TCompPool<T> *pool = GetPool<T>();
+    (funcs(pool->GetUnchecked(entity)), ...);
+    pool->NotifyUpdate(entity);
+    return pool->Get(entity);
   }
 
   template <typename T> T *GetComponent(Entity entity) {
-    return GetPool<T>()->Get(entity);
+    if (!HasComponent<T>(entity))
+      return nullptr;
+    return &GetPool<T>()->GetUnchecked(entity);
   }
 
-  template <typename T> bool HasComponent(Entity entity) {
-    return GetPool<T>()->Has(entity);
+  template <typename T> bool HasComponent(Entity entity) const {
+    return Valid(entity) &&
+           m_Signatures[EntityIndex(entity)].test(ComponentType<T>());
   }
 
   template <typename T> void RemoveComponent(Entity entity) {
+    if (!HasComponent<T>(entity))
+      return;
+    GetPool<T>()->NotifyDestroy(entity);
     GetPool<T>()->Remove(entity);
+    m_Signatures[EntityIndex(entity)].reset(ComponentType<T>());
+  }
+
+  // Creates T's pool ahead of first use.
+  template <typename T> void RegisterComponent() {
+    if constexpr (!IsTag<T>)
+      GetPool<T>();
+  }
+
+  template <typename T> void AddTag(Entity entity) {
+    static_assert(IsTag<T>, "tags must be empty structs");
+    if (Valid(entity))
+      m_Signatures[EntityIndex(entity)].set(ComponentType<T>());
+  }
+
+  template <typename T> void RemoveTag(Entity entity) {
+    static_assert(IsTag<T>, "tags must be empty structs");
+    if (Valid(entity))
+      m_Signatures[EntityIndex(entity)].reset(ComponentType<T>());
   }
 
-  template <typename T> std::unordered_map<Entity, T> &View() {
-    return GetPool<T>()->GetAll();
+  template <typename T> bool HasTag(Entity entity) const {
+    static_assert(IsTag<T>, "tags must be empty structs");
+    return Valid(entity) &&
+           m_Signatures[EntityIndex(entity)].test(ComponentType<T>());
+  }
+
+  template <typename T> void EnableTracking(bool enabled = true) {
+    GetPool<T>()->EnableTracking(enabled);
+  }
+  template <typename T> const std::vector<Entity> &Added() {
+    return GetPool<T>()->Added();
+  }
+  template <typename T> const std::vector<Entity> &Updated() {
+    return GetPool<T>()->Updated();
+  }
+  template <typename T> bool IsAdded(Entity entity) {
+    return GetPool<T>()->IsAdded(entity);
+  }
+  template <typename T> bool IsUpdated(Entity entity) {
+    return GetPool<T>()->IsUpdated(entity);
+  }
+
+  // Reorders T's pool; iteration then follows that order. Must not be called
+  // while the pool is being iterated.
+  template <typename T, typename Compare> void Sort(Compare compare) {
+    GetPool<T>()->Sort(compare);
+  }
+
+  // Arranges To's pool to match From's order, see ComponentPool::SortAs.
+  template <typename To, typename From> void SortAs() {
+    GetPool<To>()->SortAs(*GetPool<From>());
+  }
+
+  // Starts a new change-tracking window for every pool.
+  void ClearChanges() {
+    for (auto &pool : m_ComponentPools) {
+      if (pool)
+        pool->ClearChanges();
+    }
+  }
+
+  template <typename T> Signal &OnConstruct() {
+    return GetPool<T>()->OnConstruct();
+  }
+  template <typename T> Signal &OnUpdate() { return GetPool<T>()->OnUpdate(); }
+  template <typename T> Signal &OnDestroy() {
+    return GetPool<T>()->OnDestroy();
+  }
+
+  template <typename T> TCompPool<T> &View() { return *GetPool<T>(); }
+
+  template <typename T, typename U, typename... Rest>
+  TView<Exclude<>, T, U, Rest...> View() {
+    return TView<Exclude<>, T, U, Rest...>(m_Signatures, Signature(),
+                                            GetPool<T>(), GetPool<U>(),
+                                            GetPool<Rest>()...);
+  }
+
+  template <typename... Ts, typename... Xs>
+  TView<Exclude<Xs...>, Ts...> View(Exclude<Xs...>) {
+    return TView<Exclude<Xs...>, Ts...>(m_Signatures, Signature(),
+                                        GetPool<Ts>()...);
+  }
+
+  template <typename... Ts, typename... Ws>
+  TView<Exclude<>, Ts...> View(With<Ws...>) {
+    return TView<Exclude<>, Ts...>(m_Signatures, MakeSignature<Ws...>(),
+                                   GetPool<Ts>()...);
+  }
+
+  template <typename... Ts, typename... Ws, typename... Xs>
+  TView<Exclude<Xs...>, Ts...> View(With<Ws...>, Exclude<Xs...>) {
+    return TView<Exclude<Xs...>, Ts...>(m_Signatures, MakeSignature<Ws...>(),
+                                        GetPool<Ts>()...);
+  }
+
+  // Spawns count copies of the prefab. Pools grow once and construct signals
+  // fire after every component is in place.
+  std::vector<Entity> Instantiate(const Prefab &prefab, size_t count) {
+    std::vector<Entity> entities = CreateEntities(count);
+    Populate(prefab, entities, MAX_COMPONENTS);
+    FinishInstantiate(prefab.GetSignature(), entities);
+    return entities;
+  }
+
+  // One entity per value; values[i] replaces (or adds to) the prefab's T,
+  // typically to give each spawn its own position.
+  template <typename T>
+  std::vector<Entity> Instantiate(const Prefab &prefab,
+                                  const std::vector<T> &values) {
+    std::vector<Entity> entities = CreateEntities(values.size());
+    ComponentTypeId id = ComponentType<T>();
+    Populate(prefab, entities, id);
+    TCompPool<T> *pool = GetPool<T>();
+    pool->Reserve(pool->size() + values.size());
+    for (size_t i = 0; i < entities.size(); ++i)
+      pool->Add(entities[i], values[i]);
+    FinishInstantiate(prefab.GetSignature() | MakeSignature<T>(), entities);
+    return entities;
+  }
+
+  // Must not be called while systems are running.
+  RegistrySnapshot Snapshot() {
+    RegistrySnapshot snapshot;
+    snapshot.m_Entities = m_Entities;
+    snapshot.m_Alive = m_Alive;
+    snapshot.m_FreeList = m_FreeList;
+    snapshot.m_Signatures = m_Signatures;
+    snapshot.m_Pools.resize(m_ComponentPools.size());
+    for (size_t i = 0; i < m_ComponentPools.size(); ++i) {
+      if (m_ComponentPools[i])
+        snapshot.m_Pools[i] = m_ComponentPools[i]->Share();
+    }
+    return snapshot;
+  }
+
+  // Rolls every entity and component back to the snapshot. Pools created
+  // since are emptied, change tracking restarts and no signals fire.
+  // Generations never rewind: handles issued after the snapshot stay
+  // invalid rather than coming back as someone else.
+  void Restore(const RegistrySnapshot &snapshot) {
+    size_t count = std::max(m_Entities.size(), snapshot.m_Entities.size());
+    std::vector<Entity> entities(count);
+    std::vector<bool> alive(count, false);
+    m_GenerationFloor.resize(count, 0);
+    for (uint32_t index = 0; index < count; ++index) {
+      // The slot's next owner must get a generation past every handle it
+      // has had in either timeline.
+      uint32_t floor = m_GenerationFloor[index];
+      if (index < m_Entities.size())
+        floor = std::max(floor, m_Alive[index]
+                                    ? NextGeneration(m_Entities[index])
+                                    : EntityGeneration(m_Entities[index]));
+      if (index < snapshot.m_Entities.size() && snapshot.m_Alive[index]) {
+        entities[index] = snapshot.m_Entities[index];
+        alive[index] = true;
+        m_GenerationFloor[index] = floor;
+        continue;
+      }
+      if (index < snapshot.m_Entities.size())
+        floor = std::max(floor, EntityGeneration(snapshot.m_Entities[index]));
+      entities[index] = MakeEntity(index, floor);
+    }
+    m_FreeList = snapshot.m_FreeList;
+    for (uint32_t index = (uint32_t)snapshot.m_Entities.size(); index < count;
+         ++index)
+      m_FreeList.push_back(index);
+    m_Entities.swap(entities);
+    m_Alive.swap(alive);
+    m_Signatures = snapshot.m_Signatures;
+    m_Signatures.resize(count);
+    for (size_t i = 0; i < m_ComponentPools.size(); ++i) {
+      if (!m_ComponentPools[i])
+        continue;
+      m_ComponentPools[i]->Restore(
+          i < snapshot.m_Pools.size() ? snapshot.m_Pools[i] : nullptr);
+    }
   }
 
 private:
-  template <typename T> TCompPool<T> *GetPool() {
-    auto index = std::type_index(typeid(T));
-    if (m_ComponentPools.find(index) == m_ComponentPools.end()) {
-      m_ComponentPools[index] = std::make_unique<TCompPool<T>>();
+  template <typename T> friend struct Prefab::TEntry;
+
+  // The all-ones generation is skipped so no live handle can ever equal
+  // INVALID_ENTITY.
+  static uint32_t NextGeneration(Entity entity) {
+    uint32_t generation = EntityGeneration(entity) + 1;
+    return generation >= ENTITY_GENERATION_MASK ? 0 : generation;
+  }
+
+  std::vector<Entity> CreateEntities(size_t count) {
+    size_t fresh = count > m_FreeList.size() ? count - m_FreeList.size() : 0;
+    m_Entities.reserve(m_Entities.size() + fresh);
+    m_Alive.reserve(m_Alive.size() + fresh);
+    m_GenerationFloor.reserve(m_GenerationFloor.size() + fresh);
+    m_Signatures.reserve(m_Signatures.size() + fresh);
+    std::vector<Entity> entities;
+    entities.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+      entities.push_back(CreateEntity());
+    return entities;
+  }
+
+  void Populate(const Prefab &prefab, const std::vector<Entity> &entities,
+                ComponentTypeId skip) {
+    for (const auto &entry : prefab.m_Entries) {
+      if (entry->id != skip)
+        entry->Populate(*this, entities);
+    }
+  }
+
+  void FinishInstantiate(const Signature &signature,
+                         const std::vector<Entity> &entities) {
+    for (Entity entity : entities)
+      m_Signatures[EntityIndex(entity)] |= signature;
+    for (ComponentTypeId id = 0; id < m_ComponentPools.size(); ++id) {
+      if (!signature.test(id) || !m_ComponentPools[id])
+        continue;
+      for (Entity entity : entities)
+        m_ComponentPools[id]->NotifyConstruct(entity);
     }
-    return static_cast<TCompPool<T> *>(m_ComponentPools[index].get());
   }
 
-  Entity m_NextEntity = 0;
-  std::unordered_set<Entity> m_Entities;
-  std::unordered_map<std::type_index, std::unique_ptr<ComponentPool>>
-      m_ComponentPools;
+  template <typename T> TCompPool<T> *GetPool() {
+    ComponentTypeId id = ComponentType<T>();
+    assert(id < MAX_COMPONENTS && "raise MAX_COMPONENTS");
+    if (id >= m_ComponentPools.size())
+      m_ComponentPools.resize(id + 1);
+    if (!m_ComponentPools[id])
+      m_ComponentPools[id] = std::make_unique<TCompPool<T>>();
+    return static_cast<TCompPool<T> *>(m_ComponentPools[id].get());
+  }
+
+  // m_Entities holds the current handle of every slot ever issued; dead
+  // slots already carry the generation their next owner will receive.
+  std::vector<Entity> m_Entities;
+  std::vector<bool> m_Alive;
+  // Lowest generation a slot may be reissued at; raised by Restore so that
+  // a restored entity's successor skips the generations used after the
+  // snapshot.
+  std::vector<uint32_t> m_GenerationFloor;
+  std::vector<uint32_t> m_FreeList;
+  std::vector<Signature> m_Signatures;
+  std::vector<std::unique_ptr<ComponentPool>> m_ComponentPools;
 };
 
+template <typename T>
+void Prefab::TEntry<T>::Populate(Registry &registry,
+                                 const std::vector<Entity> &entities) const {
+  TCompPool<T> *pool = registry.GetPool<T>();
+  pool->Reserve(pool->size() + entities.size());
+  for (Entity entity : entities)
+    pool->Add(entity, component);
+}
+
 } // namespace PixelsEngine
@@ -0,0 +1,152 @@
+#include "FlowField.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+namespace PixelsEngine {
+
+namespace {
+// Same order as Pathfinding's A*: four straight moves, then diagonals.
+const int STEP_X[] = {0, 0, -1, 1, -1, -1, 1, 1};
+const int STEP_Y[] = {-1, 1, 0, 0, -1, 1, -1, 1};
+const int8_t OPPOSITE[] = {1, 0, 3, 2, 7, 6, 5, 4};
+
+int8_t StepIndex(int dx, int dy) {
+  for (int8_t i = 0; i < 8; ++i)
+    if (STEP_X[i] == dx && STEP_Y[i] == dy)
+      return i;
+  return -1;
+}
+} // namespace
+
+void FlowField::SetTarget(const Tilemap &map, int targetX, int targetY) {
+  if (!IsFor(map)) {
+    Build(map, targetX, targetY);
+    return;
+  }
+  int dx = targetX - m_TargetX;
+  int dy = targetY - m_TargetY;
+  if (dx == 0 && dy == 0)
+    return;
+
+  // Only a single walkable step keeps every old route valid by extending it
+  // through the old target.
+  int8_t step = StepIndex(dx, dy);
+  float stepCost = step < 4 ? Pathfinding::STRAIGHT_COST
+                            : Pathfinding::DIAGONAL_COST;
+  if (step < 0 || !map.IsWalkable(m_TargetX, m_TargetY) ||
+      !map.IsWalkable(targetX, targetY) || m_Offset + stepCost > MAX_OFFSET) {
+    Build(map, targetX, targetY);
+    return;
+  }
+
+  m_Offset += stepCost;
+  m_Direction[Index(m_TargetX, m_TargetY)] = step;
+  m_TargetX = targetX;
+  m_TargetY = targetY;
+  m_Heap.clear();
+  Seed(Index(targetX, targetY));
+  Propagate();
+}
+
+void FlowField::Build(const Tilemap &map, int targetX, int targetY) {
+  Attach(map);
+  if (++m_Generation == 0) {
+    std::fill(m_Stamp.begin(), m_Stamp.end(), 0);
+    m_Generation = 1;
+  }
+  m_Offset = 0.0f;
+  m_TargetX = targetX;
+  m_TargetY = targetY;
+  m_Heap.clear();
+  if (!InBounds(targetX, targetY))
+    return;
+  Seed(Index(targetX, targetY));
+  Propagate();
+}
+
+bool FlowField::GetDirection(int x, int y, int &dx, int &dy) const {
+  if (!IsReached(x, y))
+    return false;
+  int8_t step = m_Direction[Index(x, y)];
+  if (step < 0)
+    return false;
+  dx = STEP_X[step];
+  dy = STEP_Y[step];
+  return true;
+}
+
+bool FlowField::ExtractPath(int x, int y,
+                            std::vector<std::pair<int, int>> &path) const {
+  path.clear();
+  // Costs fall strictly along the field, so this always ends at the target;
+  // the cap only guards against misuse.
+  size_t limit = (size_t)m_Width * m_Height;
+  int dx, dy;
+  while (path.size() < limit && GetDirection(x, y, dx, dy)) {
+    x += dx;
+    y += dy;
+    path.push_back({x, y});
+  }
+  return !path.empty();
+}
+
+void FlowField::Attach(const Tilemap &map) {
+  m_Map = &map;
+  m_MapRevision = map.GetRevision();
+  m_Width = map.GetWidth();
+  m_Height = map.GetHeight();
+  size_t count = (size_t)m_Width * m_Height;
+  if (m_Stamp.size() < count) {
+    m_Cost.resize(count);
+    m_Direction.resize(count);
+    m_Stamp.resize(count, 0);
+  }
+}
+
+void FlowField::Seed(int tile) {
+  m_Stamp[tile] = m_Generation;
+  m_Cost[tile] = -m_Offset;
+  m_Direction[tile] = -1;
+  m_Heap.push_back({m_Cost[tile], tile});
+  std::push_heap(m_Heap.begin(), m_Heap.end(),
+                 std::greater<PathfindingContext::HeapEntry>());
+}
+
+// Dijkstra over stored (offset-relative) costs. Only strictly cheaper routes
+// are recorded, so an incremental update stops where the old field was
+// already as good.
+void FlowField::Propagate() {
+  auto greater = std::greater<PathfindingContext::HeapEntry>();
+  while (!m_Heap.empty()) {
+    std::pop_heap(m_Heap.begin(), m_Heap.end(), greater);
+    PathfindingContext::HeapEntry top = m_Heap.back();
+    m_Heap.pop_back();
+    int current = top.tile;
+    if (top.fCost > m_Cost[current])
+      continue;
+
+    int cx = current % m_Width;
+    int cy = current / m_Width;
+    for (int i = 0; i < 8; ++i) {
+      int nx = cx + STEP_X[i];
+      int ny = cy + STEP_Y[i];
+      if (!m_Map->IsWalkable(nx, ny))
+        continue;
+      float cost = m_Cost[current] + (i < 4 ? Pathfinding::STRAIGHT_COST
+                                            : Pathfinding::DIAGONAL_COST);
+      if (cost + m_Offset > m_MaxCost)
+        continue;
+      int neighbor = Index(nx, ny);
+      if (m_Stamp[neighbor] == m_Generation && cost >= m_Cost[neighbor])
+        continue;
+      m_Stamp[neighbor] = m_Generation;
+      m_Cost[neighbor] = cost;
+      m_Direction[neighbor] = OPPOSITE[i];
+      m_Heap.push_back({cost, neighbor});
+      std::push_heap(m_Heap.begin(), m_Heap.end(), greater);
+    }
+  }
+}
+
+} // namespace PixelsEngine
@@ -0,0 +1,85 @@
+#pragma once
+#include "Pathfinding.h"
+#include "Tilemap.h"
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace PixelsEngine {
+
+// Integration field toward one target tile: every reached tile stores its
+// path cost to the target and the neighbour to step to next, so any number
+// of agents sharing the target steer with one lookup each instead of a
+// search each. Moves use the same 8-connected costs as Pathfinding.
+//
+// Moving the target one step keeps the old field: each cost is bumped by the
+// step (routes may now continue through the old target) with a shared offset,
+// and Dijkstra only revisits tiles that got closer. A full rebuild happens
+// when the target jumps, the map's walkability changes, or the offset grows
+// large. Sampling is const and safe from several threads; updating is not.
+class FlowField {
+public:
+  // Tiles costing more than maxCost to reach the target are left unreached,
+  // which bounds the work to a disc around the target.
+  explicit FlowField(float maxCost = std::numeric_limits<float>::infinity())
+      : m_MaxCost(maxCost) {}
+
+  // Points the field at target, rebuilding or updating incrementally as
+  // needed. Cheap when nothing changed.
+  void SetTarget(const Tilemap &map, int targetX, int targetY);
+  void Build(const Tilemap &map, int targetX, int targetY);
+
+  bool IsReached(int x, int y) const {
+    return InBounds(x, y) && m_Stamp[Index(x, y)] == m_Generation;
+  }
+  // Path cost from (x, y) to the target; infinity when unreached.
+  float GetCost(int x, int y) const {
+    if (!IsReached(x, y))
+      return std::numeric_limits<float>::infinity();
+    return m_Cost[Index(x, y)] + m_Offset;
+  }
+  // Next step from (x, y) toward the target. False at the target itself and
+  // on unreached tiles.
+  bool GetDirection(int x, int y, int &dx, int &dy) const;
+
+  // Follows the field from (x, y): start exclusive, target inclusive, like
+  // Pathfinding::FindPath. Returns false when there is nothing to follow.
+  bool ExtractPath(int x, int y, std::vector<std::pair<int, int>> &path) const;
+
+  bool IsFor(const Tilemap &map) const {
+    return m_Map == &map && m_MapRevision == map.GetRevision();
+  }
+  int GetTargetX() const { return m_TargetX; }
+  int GetTargetY() const { return m_TargetY; }
+
+private:
+  // Costs are stored relative to m_Offset; past this the field is rebuilt
+  // to keep them precise and drop stale far-away entries.
+  static constexpr float MAX_OFFSET = 256.0f;
+
+  bool InBounds(int x, int y) const {
+    return m_Map && x >= 0 && y >= 0 && x < m_Width && y < m_Height;
+  }
+  int Index(int x, int y) const { return y * m_Width + x; }
+
+  void Attach(const Tilemap &map);
+  void Seed(int tile);
+  void Propagate();
+
+  const Tilemap *m_Map = nullptr;
+  uint32_t m_MapRevision = 0;
+  int m_Width = 0;
+  int m_Height = 0;
+  int m_TargetX = -1;
+  int m_TargetY = -1;
+  float m_MaxCost;
+  float m_Offset = 0.0f;
+  uint32_t m_Generation = 0;
+  std::vector<float> m_Cost;
+  std::vector<int8_t> m_Direction; // index into the step tables, -1 for none
+  std::vector<uint32_t> m_Stamp;   // m_Generation once the tile is reached
+  std::vector<PathfindingContext::HeapEntry> m_Heap;
+};
+
+} // namespace PixelsEngine
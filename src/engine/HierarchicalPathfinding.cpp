@@ -0,0 +1,472 @@
+#include "HierarchicalPathfinding.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace PixelsEngine {
+
+namespace {
+constexpr float UNREACHABLE = std::numeric_limits<float>::max();
+// Border runs at least this long get an entrance at each end instead of one
+// in the middle.
+constexpr int LONG_ENTRANCE = 6;
+} // namespace
+
+HierarchicalPathfinder::HierarchicalPathfinder(const Tilemap &map)
+    : m_Map(map), m_Width(map.GetWidth()), m_Height(map.GetHeight()),
+      m_ClustersX(map.GetRegionsX()), m_ClustersY(map.GetRegionsY()) {}
+
+void HierarchicalPathfinder::Build(JobSystem *jobs) {
+  size_t count = (size_t)m_ClustersX * m_ClustersY;
+  m_Clusters.assign(count, Cluster());
+  m_EastBorders.assign(count, Border());
+  m_SouthBorders.assign(count, Border());
+  m_CornerBorders.assign(count, Border());
+
+  // Each cluster owns its east and south borders and its lower corners, so
+  // both passes write disjoint data; clusters only read borders once all
+  // are built.
+  auto borders = [this](size_t begin, size_t end) {
+    for (size_t c = begin; c < end; ++c)
+      BuildBorders((int)c);
+  };
+  auto clusters = [this](size_t begin, size_t end) {
+    for (size_t c = begin; c < end; ++c)
+      BuildCluster((int)c);
+  };
+  if (jobs) {
+    jobs->ParallelFor(0, count, 64, borders);
+    jobs->ParallelFor(0, count, 16, clusters);
+  } else {
+    borders(0, count);
+    clusters(0, count);
+  }
+  NumberNodes();
+  m_Revision = m_Map.GetRevision();
+  m_Built = true;
+}
+
+void HierarchicalPathfinder::Refresh() {
+  if (!m_Built) {
+    Build();
+    return;
+  }
+  if (m_Map.GetRevision() == m_Revision)
+    return;
+
+  std::vector<char> affected(m_Clusters.size(), 0);
+  for (int cy = 0; cy < m_ClustersY; ++cy) {
+    for (int cx = 0; cx < m_ClustersX; ++cx) {
+      int c = cy * m_ClustersX + cx;
+      if (m_Clusters[c].revision == m_Map.GetRegionRevision(cx, cy))
+        continue;
+      // The dirty cluster's borders and corners, and every neighbour
+      // sharing them: the clusters above and to the left own theirs.
+      for (int ny = std::max(0, cy - 1); ny <= std::min(m_ClustersY - 1, cy + 1);
+           ++ny) {
+        for (int nx = std::max(0, cx - 1);
+             nx <= std::min(m_ClustersX - 1, cx + 1); ++nx) {
+          int n = ny * m_ClustersX + nx;
+          if (ny < cy || (ny == cy && nx <= cx))
+            BuildBorders(n);
+          affected[n] = 1;
+        }
+      }
+    }
+  }
+  for (size_t c = 0; c < affected.size(); ++c) {
+    if (affected[c])
+      BuildCluster((int)c);
+  }
+  NumberNodes();
+  m_Revision = m_Map.GetRevision();
+}
+
+void HierarchicalPathfinder::NumberNodes() {
+  m_NodeClusters.clear();
+  for (size_t c = 0; c < m_Clusters.size(); ++c) {
+    m_Clusters[c].firstId = (int)m_NodeClusters.size();
+    m_NodeClusters.insert(m_NodeClusters.end(), m_Clusters[c].nodes.size(),
+                          (int)c);
+  }
+}
+
+void HierarchicalPathfinder::ScanBorder(int x0, int y0, int stepX, int stepY,
+                                        int length, int crossX, int crossY,
+                                        Border &border) const {
+  border.clear();
+  auto add = [&](int i) {
+    int x = x0 + i * stepX, y = y0 + i * stepY;
+    border.push_back({y * m_Width + x, (y + crossY) * m_Width + x + crossX});
+  };
+
+  auto inside = [&](int i) {
+    return m_Map.IsWalkable(x0 + i * stepX, y0 + i * stepY);
+  };
+  auto outside = [&](int i) {
+    return m_Map.IsWalkable(x0 + i * stepX + crossX, y0 + i * stepY + crossY);
+  };
+  auto straight = [&](int i) { return inside(i) && outside(i); };
+
+  // Every tile of a run reaches the others on both sides, so a short run
+  // needs one entrance and a long one gets one at each end.
+  auto addRun = [](int runStart, int runEnd, auto &&addAt) {
+    if (runEnd - runStart + 1 < LONG_ENTRANCE) {
+      addAt((runStart + runEnd) / 2);
+    } else {
+      addAt(runStart);
+      addAt(runEnd);
+    }
+  };
+
+  int runStart = -1;
+  for (int i = 0; i <= length; ++i) {
+    bool open = i < length && straight(i);
+    if (open && runStart < 0) {
+      runStart = i;
+    } else if (!open && runStart >= 0) {
+      addRun(runStart, i - 1, add);
+      runStart = -1;
+    }
+  }
+
+  // A diagonal step between positions i and i + 1 only matters when neither
+  // straight crossing there is open; otherwise its ends already reach one
+  // of those runs on their own side. Consecutive diagonals leaning the same
+  // way form a staircase whose tiles touch on both sides, so they merge into
+  // runs like the straight ones.
+  auto lean = [&](int i) {
+    if (straight(i) || straight(i + 1))
+      return 0;
+    if (inside(i) && outside(i + 1))
+      return 1;
+    if (inside(i + 1) && outside(i))
+      return -1;
+    return 0;
+  };
+  auto addDiagonal = [&](int i, int direction) {
+    int from = direction > 0 ? i : i + 1, to = direction > 0 ? i + 1 : i;
+    int x = x0 + from * stepX, y = y0 + from * stepY;
+    int ox = x0 + to * stepX + crossX, oy = y0 + to * stepY + crossY;
+    border.push_back({y * m_Width + x, oy * m_Width + ox});
+  };
+  runStart = -1;
+  int runLean = 0;
+  for (int i = 0; i < length; ++i) {
+    int direction = i + 1 < length ? lean(i) : 0;
+    if (runStart >= 0 && direction != runLean) {
+      addRun(runStart, i - 1,
+             [&](int at) { addDiagonal(at, runLean); });
+      runStart = -1;
+    }
+    if (direction != 0 && runStart < 0) {
+      runStart = i;
+      runLean = direction;
+    }
+  }
+}
+
+void HierarchicalPathfinder::ScanCorners(int cluster, Border &corners) const {
+  corners.clear();
+  int cx = cluster % m_ClustersX, cy = cluster / m_ClustersX;
+  if (cy + 1 >= m_ClustersY)
+    return;
+  int y = (cy + 1) * CLUSTER_SIZE - 1;
+  // Clusters meeting only at a corner connect through a diagonal step, but
+  // only when neither tile beside it is open; otherwise the step is covered
+  // by the straight borders of the cluster those tiles belong to.
+  auto add = [&](int x, int dx) {
+    if (m_Map.IsWalkable(x, y) && m_Map.IsWalkable(x + dx, y + 1) &&
+        !m_Map.IsWalkable(x + dx, y) && !m_Map.IsWalkable(x, y + 1))
+      corners.push_back({y * m_Width + x, (y + 1) * m_Width + x + dx});
+  };
+  if (cx + 1 < m_ClustersX)
+    add((cx + 1) * CLUSTER_SIZE - 1, 1);
+  if (cx > 0)
+    add(cx * CLUSTER_SIZE, -1);
+}
+
+void HierarchicalPathfinder::BuildBorders(int cluster) {
+  int cx = cluster % m_ClustersX, cy = cluster / m_ClustersX;
+  if (cx + 1 < m_ClustersX) {
+    int y0 = cy * CLUSTER_SIZE;
+    ScanBorder((cx + 1) * CLUSTER_SIZE - 1, y0, 0, 1,
+               std::min(CLUSTER_SIZE, m_Height - y0), 1, 0,
+               m_EastBorders[cluster]);
+  }
+  if (cy + 1 < m_ClustersY) {
+    int x0 = cx * CLUSTER_SIZE;
+    ScanBorder(x0, (cy + 1) * CLUSTER_SIZE - 1, 1, 0,
+               std::min(CLUSTER_SIZE, m_Width - x0), 0, 1,
+               m_SouthBorders[cluster]);
+  }
+  ScanCorners(cluster, m_CornerBorders[cluster]);
+}
+
+void HierarchicalPathfinder::BuildCluster(int cluster) {
+  int cx = cluster % m_ClustersX, cy = cluster / m_ClustersX;
+  Cluster &target = m_Clusters[cluster];
+  target.nodes.clear();
+
+  auto addNode = [&](int tile, int partner) {
+    for (Node &node : target.nodes) {
+      if (node.tile == tile) {
+        assert(node.partnerCount < MAX_PARTNERS);
+        node.partners[node.partnerCount++] = partner;
+        return;
+      }
+    }
+    target.nodes.push_back({tile, {partner}, 1});
+  };
+  if (cx + 1 < m_ClustersX)
+    for (auto &entrance : m_EastBorders[cluster])
+      addNode(entrance.first, entrance.second);
+  if (cx > 0)
+    for (auto &entrance : m_EastBorders[cluster - 1])
+      addNode(entrance.second, entrance.first);
+  if (cy + 1 < m_ClustersY)
+    for (auto &entrance : m_SouthBorders[cluster])
+      addNode(entrance.first, entrance.second);
+  if (cy > 0)
+    for (auto &entrance : m_SouthBorders[cluster - m_ClustersX])
+      addNode(entrance.second, entrance.first);
+  for (auto &entrance : m_CornerBorders[cluster])
+    addNode(entrance.first, entrance.second);
+  if (cy > 0) {
+    // Corners of the two clusters diagonally above that land here.
+    for (int dx = -1; dx <= 1; dx += 2) {
+      if (cx + dx < 0 || cx + dx >= m_ClustersX)
+        continue;
+      for (auto &entrance : m_CornerBorders[cluster - m_ClustersX + dx])
+        if (ClusterOf(entrance.second) == cluster)
+          addNode(entrance.second, entrance.first);
+    }
+  }
+
+  size_t count = target.nodes.size();
+  target.costs.assign(count * count, UNREACHABLE);
+  thread_local PathfindingContext context;
+  for (size_t i = 0; i < count; ++i) {
+    SearchCluster(cluster, target.nodes[i].tile, -1, context);
+    for (size_t j = 0; j < count; ++j) {
+      int local = LocalIndex(target.nodes[j].tile);
+      if (context.IsSeen(local))
+        target.costs[i * count + j] = context.GetCost(local);
+    }
+  }
+  target.revision = m_Map.GetRegionRevision(cx, cy);
+}
+
+void HierarchicalPathfinder::SearchCluster(int cluster, int sourceTile,
+                                           int targetTile,
+                                           PathfindingContext &context) const {
+  static const int dx[] = {0, 0, -1, 1, -1, -1, 1, 1};
+  static const int dy[] = {-1, 1, 0, 0, -1, 1, -1, 1};
+
+  int x0 = (cluster % m_ClustersX) * CLUSTER_SIZE;
+  int y0 = (cluster / m_ClustersX) * CLUSTER_SIZE;
+  int x1 = std::min(m_Width, x0 + CLUSTER_SIZE);
+  int y1 = std::min(m_Height, y0 + CLUSTER_SIZE);
+  int target = targetTile >= 0 ? LocalIndex(targetTile) : -1;
+
+  context.Reset(CLUSTER_SIZE * CLUSTER_SIZE);
+  context.Open(LocalIndex(sourceTile), 0.0f, -1, 0.0f);
+  while (!context.Empty()) {
+    int current = context.Pop().tile;
+    if (context.IsClosed(current))
+      continue;
+    context.Close(current);
+    if (current == target)
+      return;
+
+    int cx = x0 + current % CLUSTER_SIZE;
+    int cy = y0 + current / CLUSTER_SIZE;
+    for (int i = 0; i < 8; ++i) {
+      int nx = cx + dx[i], ny = cy + dy[i];
+      if (nx < x0 || ny < y0 || nx >= x1 || ny >= y1 ||
+          !m_Map.IsWalkable(nx, ny))
+        continue;
+      int neighbor = (ny - y0) * CLUSTER_SIZE + (nx - x0);
+      if (context.IsClosed(neighbor))
+        continue;
+      float gCost = context.GetCost(current) +
+                    (i < 4 ? Pathfinding::STRAIGHT_COST
+                           : Pathfinding::DIAGONAL_COST);
+      if (!context.IsSeen(neighbor) || gCost < context.GetCost(neighbor))
+        context.Open(neighbor, gCost, current, 0.0f);
+    }
+  }
+}
+
+int HierarchicalPathfinder::LocalIndex(int tile) const {
+  int x = tile % m_Width, y = tile / m_Width;
+  return (y % CLUSTER_SIZE) * CLUSTER_SIZE + x % CLUSTER_SIZE;
+}
+
+int HierarchicalPathfinder::NodeIndex(int cluster, int tile) const {
+  const auto &nodes = m_Clusters[cluster].nodes;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i].tile == tile)
+      return (int)i;
+  }
+  return -1;
+}
+
+bool HierarchicalPathfinder::FindAbstractPath(int startX, int startY,
+                                              int endX, int endY,
+                                              HierarchicalPath &path) const {
+  path.waypoints.clear();
+  path.nextSegment = 0;
+  if (!m_Built || !m_Map.IsWalkable(endX, endY) ||
+      (startX == endX && startY == endY))
+    return false;
+  if (startX < 0 || startY < 0 || startX >= m_Width || startY >= m_Height)
+    return false;
+
+  thread_local PathfindingContext local;
+  thread_local PathfindingContext search;
+  int start = startY * m_Width + startX;
+  int end = endY * m_Width + endX;
+  int startCluster = ClusterOf(start);
+  int endCluster = ClusterOf(end);
+
+  // Grid costs are symmetric, so one search from the goal prices every
+  // entrance of its cluster.
+  const Cluster &goal = m_Clusters[endCluster];
+  thread_local std::vector<float> goalCost;
+  goalCost.resize(goal.nodes.size());
+  SearchCluster(endCluster, end, -1, local);
+  for (size_t j = 0; j < goal.nodes.size(); ++j) {
+    int tile = LocalIndex(goal.nodes[j].tile);
+    goalCost[j] = local.IsSeen(tile) ? local.GetCost(tile) : -1.0f;
+  }
+
+  // Abstract node ids number every cluster's nodes in turn; the goal gets
+  // the id past the end.
+  int goalId = (int)m_NodeClusters.size();
+  search.Reset(goalId + 1);
+  SearchCluster(startCluster, start, -1, local);
+  if (startCluster == endCluster && local.IsSeen(LocalIndex(end)))
+    search.Open(goalId, local.GetCost(LocalIndex(end)), -1, 0.0f);
+  const Cluster &first = m_Clusters[startCluster];
+  for (size_t i = 0; i < first.nodes.size(); ++i) {
+    int tile = LocalIndex(first.nodes[i].tile);
+    if (local.IsSeen(tile))
+      search.Open(first.firstId + (int)i,
+                  local.GetCost(tile), -1,
+                  Heuristic(first.nodes[i].tile, endX, endY));
+  }
+
+  while (!search.Empty()) {
+    int id = search.Pop().tile;
+    if (search.IsClosed(id))
+      continue;
+    search.Close(id);
+
+    if (id == goalId) {
+      path.waypoints.push_back({endX, endY});
+      for (int n = search.GetParent(goalId); n != -1; n = search.GetParent(n)) {
+        const Cluster &owner = m_Clusters[m_NodeClusters[n]];
+        int tile = owner.nodes[n - owner.firstId].tile;
+        path.waypoints.push_back({tile % m_Width, tile / m_Width});
+      }
+      path.waypoints.push_back({startX, startY});
+      std::reverse(path.waypoints.begin(), path.waypoints.end());
+      return true;
+    }
+
+    int c = m_NodeClusters[id];
+    const Cluster &cluster = m_Clusters[c];
+    int i = id - cluster.firstId;
+    const Node &node = cluster.nodes[i];
+    float g = search.GetCost(id);
+    auto relax = [&](int next, float cost, float h) {
+      if (search.IsClosed(next))
+        return;
+      if (!search.IsSeen(next) || cost < search.GetCost(next))
+        search.Open(next, cost, id, h);
+    };
+
+    if (c == endCluster && goalCost[i] >= 0.0f)
+      relax(goalId, g + goalCost[i], 0.0f);
+    size_t count = cluster.nodes.size();
+    for (size_t j = 0; j < count; ++j) {
+      float cost = cluster.costs[i * count + j];
+      if (j != (size_t)i && cost != UNREACHABLE)
+        relax(cluster.firstId + (int)j, g + cost,
+              Heuristic(cluster.nodes[j].tile, endX, endY));
+    }
+    for (int p = 0; p < node.partnerCount; ++p) {
+      int partner = node.partners[p];
+      int pc = ClusterOf(partner);
+      int j = NodeIndex(pc, partner);
+      bool diagonal = partner % m_Width != node.tile % m_Width &&
+                      partner / m_Width != node.tile / m_Width;
+      if (j >= 0)
+        relax(m_Clusters[pc].firstId + j,
+              g + (diagonal ? Pathfinding::DIAGONAL_COST
+                            : Pathfinding::STRAIGHT_COST),
+              Heuristic(partner, endX, endY));
+    }
+  }
+  return false;
+}
+
+bool HierarchicalPathfinder::RefineNext(
+    HierarchicalPath &path, std::vector<std::pair<int, int>> &steps) const {
+  while (!path.Done()) {
+    auto from = path.waypoints[path.nextSegment];
+    auto to = path.waypoints[path.nextSegment + 1];
+    ++path.nextSegment;
+    if (from == to)
+      continue;
+
+    int fromTile = from.second * m_Width + from.first;
+    int toTile = to.second * m_Width + to.first;
+    int cluster = ClusterOf(fromTile);
+    if (cluster != ClusterOf(toTile)) {
+      steps.push_back(to); // border crossing
+      return true;
+    }
+
+    thread_local PathfindingContext local;
+    SearchCluster(cluster, fromTile, toTile, local);
+    int target = LocalIndex(toTile);
+    if (!local.IsClosed(target))
+      return false; // the map changed under this path
+
+    int x0 = (cluster % m_ClustersX) * CLUSTER_SIZE;
+    int y0 = (cluster / m_ClustersX) * CLUSTER_SIZE;
+    size_t first = steps.size();
+    for (int t = target; t != -1 && t != LocalIndex(fromTile);
+         t = local.GetParent(t))
+      steps.push_back({x0 + t % CLUSTER_SIZE, y0 + t / CLUSTER_SIZE});
+    std::reverse(steps.begin() + first, steps.end());
+    return true;
+  }
+  return false;
+}
+
+std::vector<std::pair<int, int>>
+HierarchicalPathfinder::FindPath(int startX, int startY, int endX,
+                                 int endY) const {
+  std::vector<std::pair<int, int>> steps;
+  HierarchicalPath path;
+  if (!FindAbstractPath(startX, startY, endX, endY, path))
+    return steps;
+  while (RefineNext(path, steps)) {
+  }
+  if (!path.Done() || steps.empty() || steps.back() != std::make_pair(endX, endY))
+    steps.clear();
+  return steps;
+}
+
+size_t HierarchicalPathfinder::GetNodeCount() const {
+  size_t count = 0;
+  for (const Cluster &cluster : m_Clusters)
+    count += cluster.nodes.size();
+  return count;
+}
+
+} // namespace PixelsEngine
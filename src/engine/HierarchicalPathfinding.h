@@ -0,0 +1,124 @@
+#pragma once
+#include "Pathfinding.h"
+#include "Tilemap.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace PixelsEngine {
+
+class JobSystem;
+
+// Route through the abstract graph: start, entrance tiles, goal. Consecutive
+// waypoints share a cluster or sit on either side of a cluster border, and
+// are turned into tile steps one segment at a time by RefineNext.
+struct HierarchicalPath {
+  std::vector<std::pair<int, int>> waypoints;
+  size_t nextSegment = 0;
+
+  bool Done() const { return nextSegment + 1 >= waypoints.size(); }
+};
+
+// HPA* over a Tilemap. The map is cut into clusters matching the tilemap's
+// revision regions; walkable runs along each cluster border, and runs of
+// diagonal steps where no straight crossing is open, become entrance nodes
+// (as many as the border needs), and the cost between every pair of
+// entrances inside a cluster is precomputed. Queries search that small graph
+// and refine lazily.
+//
+// Build() and Refresh() belong to the main thread. Queries only read, so
+// they may run on several threads at once, but not alongside Refresh() or
+// map edits.
+class HierarchicalPathfinder {
+public:
+  static constexpr int CLUSTER_SIZE = Tilemap::REGION_SIZE;
+  static constexpr float HEURISTIC_WEIGHT = 1.1f;
+
+  explicit HierarchicalPathfinder(const Tilemap &map);
+
+  // Builds every cluster; spreads the work over jobs when given.
+  void Build(JobSystem *jobs = nullptr);
+  // Rebuilds the clusters whose region revision changed, with the
+  // neighbours sharing their entrances. Call after editing the map and
+  // before querying; a no-op when nothing changed.
+  void Refresh();
+
+  // Abstract route from start to end. Fails before Build(), or when the end
+  // is blocked, equal to the start, or unreachable through the entrance
+  // graph.
+  bool FindAbstractPath(int startX, int startY, int endX, int endY,
+                        HierarchicalPath &path) const;
+
+  // Appends the steps of the next unrefined segment (start exclusive, end
+  // inclusive). Returns false once the path is fully refined.
+  bool RefineNext(HierarchicalPath &path,
+                  std::vector<std::pair<int, int>> &steps) const;
+
+  // Abstract search plus full refinement, in Pathfinding::FindPath's format.
+  std::vector<std::pair<int, int>> FindPath(int startX, int startY, int endX,
+                                            int endY) const;
+
+  size_t GetNodeCount() const;
+
+private:
+  // Partners are distinct neighbours outside the cluster, so even a tile in
+  // a one-tile-wide cluster at the map edge cannot have more.
+  static constexpr int MAX_PARTNERS = 8;
+
+  struct Node {
+    int tile;
+    int partners[MAX_PARTNERS]; // tiles across a border or corner
+    int partnerCount;
+  };
+
+  struct Cluster {
+    std::vector<Node> nodes;
+    std::vector<float> costs; // nodes.size() squared, row per source node
+    uint32_t revision = 0;
+    int firstId = 0; // abstract id of nodes[0]
+  };
+
+  // Entrance pairs (tile in this cluster, tile in the neighbour).
+  using Border = std::vector<std::pair<int, int>>;
+
+  void BuildBorders(int cluster);
+  void BuildCluster(int cluster);
+  // Hands out abstract node ids after clusters gained or lost nodes.
+  void NumberNodes();
+  void ScanBorder(int x0, int y0, int stepX, int stepY, int length, int crossX,
+                  int crossY, Border &border) const;
+  void ScanCorners(int cluster, Border &corners) const;
+
+  // Dijkstra confined to one cluster, from tile until target is settled
+  // (or the cluster is exhausted when target is -1).
+  void SearchCluster(int cluster, int sourceTile, int targetTile,
+                     PathfindingContext &context) const;
+  int LocalIndex(int tile) const;
+
+  int ClusterOf(int tile) const {
+    int x = tile % m_Width, y = tile / m_Width;
+    return (y / CLUSTER_SIZE) * m_ClustersX + x / CLUSTER_SIZE;
+  }
+  int NodeIndex(int cluster, int tile) const;
+  // Inflated slightly: entrance graphs are full of near-equal routes, and an
+  // exact heuristic expands most of them. Costs at most 10% in path length.
+  float Heuristic(int tile, int endX, int endY) const {
+    return HEURISTIC_WEIGHT *
+           Pathfinding::Heuristic(tile % m_Width, tile / m_Width, endX, endY);
+  }
+
+  const Tilemap &m_Map;
+  int m_Width;
+  int m_Height;
+  int m_ClustersX;
+  int m_ClustersY;
+  uint32_t m_Revision = 0;
+  bool m_Built = false;
+  std::vector<Cluster> m_Clusters;
+  std::vector<int> m_NodeClusters; // owning cluster, by abstract node id
+  std::vector<Border> m_EastBorders;  // with cluster + 1
+  std::vector<Border> m_SouthBorders; // with cluster + m_ClustersX
+  std::vector<Border> m_CornerBorders; // with the two clusters diagonally below
+};
+
+} // namespace PixelsEngine
@@ -0,0 +1,267 @@
+#include "JobSystem.h"
+
+namespace PixelsEngine {
+
+namespace {
+// Identifies the worker the current thread belongs to, if any.
+thread_local JobSystem *t_Owner = nullptr;
+thread_local size_t t_WorkerIndex = 0;
+} // namespace
+
+JobSystem::JobSystem(unsigned workerCount) {
+#ifndef __EMSCRIPTEN__
+  if (workerCount == 0) {
+    unsigned cores = std::thread::hardware_concurrency();
+    workerCount = cores > 1 ? cores - 1 : 0;
+  }
+  for (unsigned i = 0; i < workerCount; ++i)
+    m_Workers.push_back(std::make_unique<Worker>());
+  for (size_t i = 0; i < m_Workers.size(); ++i)
+    m_Workers[i]->thread = std::thread(&JobSystem::WorkerLoop, this, i);
+#endif
+  m_StatsStart = std::chrono::steady_clock::now();
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(m_WakeMutex);
+    m_Stop = true;
+  }
+  m_WakeCondition.notify_all();
+  for (auto &worker : m_Workers)
+    worker->thread.join();
+}
+
+void JobSystem::Run(std::function<void()> func, JobCounter *counter,
+                    std::initializer_list<JobCounter *> dependsOn) {
+  Run(std::move(func), counter, std::vector<JobCounter *>(dependsOn));
+}
+
+void JobSystem::Run(std::function<void()> func, JobCounter *counter,
+                    const std::vector<JobCounter *> &dependsOn) {
+  auto job = std::make_shared<PendingJob>();
+  job->func = std::move(func);
+  job->counter = counter;
+  if (counter)
+    counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+  // The extra unit keeps the job parked until every dependency has been
+  // inspected, whichever thread happens to release it.
+  job->unmetDependencies = (int)dependsOn.size() + 1;
+  for (JobCounter *dependency : dependsOn) {
+    std::lock_guard<std::mutex> lock(dependency->m_Mutex);
+    if (dependency->IsDone())
+      job->unmetDependencies.fetch_sub(1);
+    else
+      dependency->m_Waiters.push_back(job);
+  }
+  if (job->unmetDependencies.fetch_sub(1) == 1)
+    Enqueue(std::move(job));
+}
+
+void JobSystem::RunBackground(std::function<void()> func,
+                              JobCounter *counter) {
+  auto job = std::make_shared<PendingJob>();
+  job->func = std::move(func);
+  job->counter = counter;
+  job->background = true;
+  if (counter)
+    counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+  Enqueue(std::move(job));
+}
+
+void JobSystem::Enqueue(std::shared_ptr<PendingJob> job) {
+  if (m_Workers.empty()) {
+    Execute(job, nullptr);
+    return;
+  }
+
+  if (job->background) {
+    {
+      std::lock_guard<std::mutex> lock(m_BackgroundMutex);
+      m_Background.push_back(std::move(job));
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_WakeMutex);
+      m_BackgroundQueued.fetch_add(1);
+    }
+    m_WakeCondition.notify_one();
+    return;
+  }
+
+  size_t index = (t_Owner == this)
+                     ? t_WorkerIndex
+                     : m_NextQueue.fetch_add(1) % m_Workers.size();
+  {
+    std::lock_guard<std::mutex> lock(m_Workers[index]->mutex);
+    m_Workers[index]->queue.push_back(std::move(job));
+  }
+  bool waiting;
+  {
+    std::lock_guard<std::mutex> lock(m_WakeMutex);
+    m_Queued.fetch_add(1);
+    waiting = m_Waiting > 0;
+  }
+  m_WakeCondition.notify_one();
+  // A waiting thread may as well help with it.
+  if (waiting)
+    m_WaitCondition.notify_all();
+}
+
+void JobSystem::Execute(const std::shared_ptr<PendingJob> &job,
+                        Worker *worker) {
+  auto start = std::chrono::steady_clock::now();
+  job->func();
+  if (worker) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    worker->busyNanoseconds.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+    worker->jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (job->counter)
+    Finish(job->counter);
+}
+
+void JobSystem::Finish(JobCounter *counter) {
+  std::vector<std::shared_ptr<PendingJob>> released;
+  {
+    // Decrement under the lock so Run() never sees a counter that has
+    // drained but not yet released its waiters.
+    std::lock_guard<std::mutex> lock(counter->m_Mutex);
+    if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      return;
+    released.swap(counter->m_Waiters);
+  }
+  // Taking the lock orders this after a waiter's last IsDone() check, so the
+  // wake-up cannot slip in before it sleeps.
+  bool waiting;
+  {
+    std::lock_guard<std::mutex> lock(m_WakeMutex);
+    waiting = m_Waiting > 0;
+  }
+  if (waiting)
+    m_WaitCondition.notify_all();
+  for (auto &job : released) {
+    if (job->unmetDependencies.fetch_sub(1) == 1)
+      Enqueue(std::move(job));
+  }
+}
+
+std::shared_ptr<PendingJob> JobSystem::PopOwn(Worker &worker) {
+  std::lock_guard<std::mutex> lock(worker.mutex);
+  if (worker.queue.empty())
+    return nullptr;
+  auto job = std::move(worker.queue.back());
+  worker.queue.pop_back();
+  m_Queued.fetch_sub(1);
+  return job;
+}
+
+std::shared_ptr<PendingJob> JobSystem::Steal(size_t thief) {
+  size_t count = m_Workers.size();
+  for (size_t offset = 1; offset <= count; ++offset) {
+    Worker &victim = *m_Workers[(thief + offset) % count];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (victim.queue.empty())
+      continue;
+    auto job = std::move(victim.queue.front());
+    victim.queue.pop_front();
+    m_Queued.fetch_sub(1);
+    return job;
+  }
+  return nullptr;
+}
+
+std::shared_ptr<PendingJob> JobSystem::PopBackground() {
+  std::lock_guard<std::mutex> lock(m_BackgroundMutex);
+  if (m_Background.empty())
+    return nullptr;
+  auto job = std::move(m_Background.front());
+  m_Background.pop_front();
+  m_BackgroundQueued.fetch_sub(1);
+  return job;
+}
+
+void JobSystem::Wait(JobCounter &counter) {
+  while (!counter.IsDone()) {
+    std::shared_ptr<PendingJob> job;
+    Worker *worker = nullptr;
+    if (t_Owner == this) {
+      worker = m_Workers[t_WorkerIndex].get();
+      job = PopOwn(*worker);
+      if (!job)
+        job = Steal(t_WorkerIndex);
+    } else if (!m_Workers.empty()) {
+      job = Steal(m_NextQueue.load() % m_Workers.size());
+    }
+    if (job) {
+      Execute(job, worker);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_WakeMutex);
+    ++m_Waiting;
+    m_WaitCondition.wait(
+        lock, [&]() { return counter.IsDone() || m_Queued > 0; });
+    --m_Waiting;
+  }
+  // Finish() may still hold the lock after the final decrement; take it once
+  // so the caller can safely destroy the counter when we return.
+  std::lock_guard<std::mutex> lock(counter.m_Mutex);
+}
+
+void JobSystem::WorkerLoop(size_t index) {
+  t_Owner = this;
+  t_WorkerIndex = index;
+  Worker &self = *m_Workers[index];
+
+  while (true) {
+    auto job = PopOwn(self);
+    if (!job) {
+      job = Steal(index);
+      if (job)
+        self.jobsStolen.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!job)
+      job = PopBackground();
+    if (job) {
+      Execute(job, &self);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_WakeMutex);
+    m_WakeCondition.wait(lock, [this]() {
+      return m_Stop || m_Queued > 0 || m_BackgroundQueued > 0;
+    });
+    if (m_Stop)
+      return;
+  }
+}
+
+std::vector<WorkerStats> JobSystem::GetWorkerStats() const {
+  double wall = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - m_StatsStart)
+                    .count();
+  std::vector<WorkerStats> stats;
+  for (const auto &worker : m_Workers) {
+    WorkerStats entry;
+    entry.jobsExecuted = worker->jobsExecuted.load();
+    entry.jobsStolen = worker->jobsStolen.load();
+    entry.busySeconds = worker->busyNanoseconds.load() / 1e9;
+    entry.utilization = wall > 0.0 ? entry.busySeconds / wall : 0.0;
+    stats.push_back(entry);
+  }
+  return stats;
+}
+
+void JobSystem::ResetStats() {
+  for (auto &worker : m_Workers) {
+    worker->jobsExecuted = 0;
+    worker->jobsStolen = 0;
+    worker->busyNanoseconds = 0;
+  }
+  m_StatsStart = std::chrono::steady_clock::now();
+}
+
+} // namespace PixelsEngine
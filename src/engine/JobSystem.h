@@ -0,0 +1,127 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PixelsEngine {
+
+struct PendingJob;
+
+// Counts outstanding jobs. A counter reaches zero when every job submitted
+// against it has finished; other jobs may name it as a dependency.
+class JobCounter {
+public:
+  bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+private:
+  friend class JobSystem;
+  std::atomic<int> m_Pending{0};
+  std::mutex m_Mutex;
+  std::vector<std::shared_ptr<PendingJob>> m_Waiters;
+};
+
+struct PendingJob {
+  std::function<void()> func;
+  JobCounter *counter = nullptr;
+  std::atomic<int> unmetDependencies{0};
+  bool background = false;
+};
+
+struct WorkerStats {
+  uint64_t jobsExecuted = 0;
+  uint64_t jobsStolen = 0;
+  double busySeconds = 0.0;
+  double utilization = 0.0; // busySeconds over wall time since ResetStats()
+};
+
+// Fixed pool of worker threads, each with its own deque. Owners push and pop
+// at the back; idle workers steal from the front of a victim's deque. Threads
+// that wait on a counter execute queued jobs instead of blocking. Background
+// jobs sit in a separate queue that workers only reach once the deques are
+// empty and waiting threads never touch, so a long search cannot hold up
+// the frame that happens to be waiting.
+class JobSystem {
+public:
+  // workerCount 0 picks hardware_concurrency - 1. With no workers (single
+  // core or Emscripten) jobs run inline on the submitting thread.
+  explicit JobSystem(unsigned workerCount = 0);
+  ~JobSystem();
+
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  void Run(std::function<void()> func, JobCounter *counter = nullptr,
+           std::initializer_list<JobCounter *> dependsOn = {});
+  void Run(std::function<void()> func, JobCounter *counter,
+           const std::vector<JobCounter *> &dependsOn);
+
+  // For work that may span frames (path searches, map builds) and is polled
+  // through the counter rather than waited on each frame.
+  void RunBackground(std::function<void()> func, JobCounter *counter);
+
+  // Blocks until the counter drains, running other queued jobs (never
+  // background ones) meanwhile and sleeping when there are none.
+  void Wait(JobCounter &counter);
+
+  // Splits [begin, end) into chunks of at most grainSize indices and calls
+  // func(chunkBegin, chunkEnd) for each, returning once all have run.
+  template <typename Func>
+  void ParallelFor(size_t begin, size_t end, size_t grainSize, Func func) {
+    if (begin >= end)
+      return;
+    if (grainSize == 0)
+      grainSize = 1;
+    JobCounter counter;
+    for (size_t chunk = begin; chunk < end; chunk += grainSize) {
+      size_t chunkEnd = std::min(end, chunk + grainSize);
+      Run([&func, chunk, chunkEnd]() { func(chunk, chunkEnd); }, &counter);
+    }
+    Wait(counter);
+  }
+
+  unsigned GetWorkerCount() const { return (unsigned)m_Workers.size(); }
+  std::vector<WorkerStats> GetWorkerStats() const;
+  void ResetStats();
+
+private:
+  struct Worker {
+    std::deque<std::shared_ptr<PendingJob>> queue;
+    mutable std::mutex mutex;
+    std::thread thread;
+    std::atomic<uint64_t> jobsExecuted{0};
+    std::atomic<uint64_t> jobsStolen{0};
+    std::atomic<uint64_t> busyNanoseconds{0};
+  };
+
+  void Enqueue(std::shared_ptr<PendingJob> job);
+  void Execute(const std::shared_ptr<PendingJob> &job, Worker *worker);
+  void Finish(JobCounter *counter);
+  std::shared_ptr<PendingJob> PopOwn(Worker &worker);
+  std::shared_ptr<PendingJob> Steal(size_t thief);
+  std::shared_ptr<PendingJob> PopBackground();
+  void WorkerLoop(size_t index);
+
+  std::vector<std::unique_ptr<Worker>> m_Workers;
+  std::atomic<size_t> m_NextQueue{0};
+  std::atomic<int> m_Queued{0}; // in the worker deques
+  std::deque<std::shared_ptr<PendingJob>> m_Background;
+  std::mutex m_BackgroundMutex;
+  std::atomic<int> m_BackgroundQueued{0};
+  std::atomic<bool> m_Stop{false};
+  std::mutex m_WakeMutex;
+  std::condition_variable m_WakeCondition; // idle workers
+  std::condition_variable m_WaitCondition; // threads inside Wait()
+  int m_Waiting = 0;                       // guarded by m_WakeMutex
+  std::chrono::steady_clock::time_point m_StatsStart;
+};
+
+} // namespace PixelsEngine
@@ -0,0 +1,111 @@
+#include "MovementRange.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace PixelsEngine {
+
+namespace {
+// Same order as Pathfinding's A*: four straight moves, then diagonals.
+const int STEP_X[] = {0, 0, -1, 1, -1, -1, 1, 1};
+const int STEP_Y[] = {-1, 1, 0, 0, -1, 1, -1, 1};
+} // namespace
+
+void MovementRange::Build(const Tilemap &map, int originX, int originY,
+                          float budget, const OccupancyGrid *occupancy,
+                          Entity agent) {
+  m_Map = &map;
+  m_MapRevision = map.GetRevision();
+  m_Occupancy = occupancy;
+  m_Agent = agent;
+  m_Width = map.GetWidth();
+  m_Height = map.GetHeight();
+  size_t count = (size_t)m_Width * m_Height;
+  if (m_Stamp.size() < count) {
+    m_Cost.resize(count);
+    m_Parent.resize(count);
+    m_Stamp.resize(count, 0);
+  }
+  if (++m_Generation == 0) {
+    std::fill(m_Stamp.begin(), m_Stamp.end(), 0);
+    m_Generation = 1;
+  }
+  m_OriginX = originX;
+  m_OriginY = originY;
+  m_Budget = budget;
+  m_Heap.clear();
+  m_Tiles.clear();
+  if (!InBounds(originX, originY))
+    return;
+
+  int origin = Index(originX, originY);
+  m_Stamp[origin] = m_Generation;
+  m_Cost[origin] = 0.0f;
+  m_Parent[origin] = -1;
+  m_Heap.push_back({0.0f, origin});
+  Propagate();
+}
+
+void MovementRange::Extend(float budget) {
+  if (!m_Map || budget <= m_Budget)
+    return;
+  m_Budget = budget;
+  Propagate();
+}
+
+float MovementRange::GetCost(int x, int y) const {
+  if (!Contains(x, y))
+    return std::numeric_limits<float>::infinity();
+  return m_Cost[Index(x, y)];
+}
+
+bool MovementRange::ExtractPath(int x, int y,
+                                std::vector<std::pair<int, int>> &path) const {
+  path.clear();
+  if (!Contains(x, y))
+    return false;
+  for (int tile = Index(x, y); m_Parent[tile] != -1; tile = m_Parent[tile])
+    path.push_back({tile % m_Width, tile / m_Width});
+  std::reverse(path.begin(), path.end());
+  return !path.empty();
+}
+
+// Dijkstra that stops at the first tile over budget and leaves it, with the
+// rest of the frontier, in the heap for Extend to pick up.
+void MovementRange::Propagate() {
+  auto greater = std::greater<PathfindingContext::HeapEntry>();
+  while (!m_Heap.empty()) {
+    PathfindingContext::HeapEntry top = m_Heap.front();
+    if (top.fCost > m_Budget)
+      break;
+    std::pop_heap(m_Heap.begin(), m_Heap.end(), greater);
+    m_Heap.pop_back();
+    int current = top.tile;
+    if (top.fCost > m_Cost[current])
+      continue;
+    m_Tiles.push_back({current % m_Width, current / m_Width});
+
+    int cx = current % m_Width;
+    int cy = current / m_Width;
+    for (int i = 0; i < 8; ++i) {
+      int nx = cx + STEP_X[i];
+      int ny = cy + STEP_Y[i];
+      if (!m_Map->IsWalkable(nx, ny))
+        continue;
+      if (m_Occupancy && m_Occupancy->IsOccupied(nx, ny, m_Agent))
+        continue;
+      float cost = m_Cost[current] + (i < 4 ? Pathfinding::STRAIGHT_COST
+                                            : Pathfinding::DIAGONAL_COST);
+      int neighbor = Index(nx, ny);
+      if (m_Stamp[neighbor] == m_Generation && cost >= m_Cost[neighbor])
+        continue;
+      m_Stamp[neighbor] = m_Generation;
+      m_Cost[neighbor] = cost;
+      m_Parent[neighbor] = current;
+      m_Heap.push_back({cost, neighbor});
+      std::push_heap(m_Heap.begin(), m_Heap.end(), greater);
+    }
+  }
+}
+
+} // namespace PixelsEngine
@@ -0,0 +1,81 @@
+#pragma once
+#include "ECS.h"
+#include "OccupancyGrid.h"
+#include "Pathfinding.h"
+#include "Tilemap.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace PixelsEngine {
+
+// Every tile one mover can reach from where it stands on a limited movement
+// budget: a Dijkstra flood cut off at the budget, keeping each tile's cost
+// and the neighbour it was reached from. Built once when a turn starts, it
+// answers "can I get there" in O(1) and hands back the route in O(length),
+// and its tile list drives a range overlay. Moves use the same 8-connected
+// costs as Pathfinding; tiles other creatures stand on are impassable.
+//
+// Raising the budget (a Dash, say) resumes the flood from where it stopped
+// instead of starting over, since Dijkstra settles tiles in cost order.
+class MovementRange {
+public:
+  // Floods from (originX, originY). Occupancy and agent are optional; the
+  // map and occupancy must outlive the range and stay unchanged until the
+  // next Build, so rebuild when IsFrom says otherwise.
+  void Build(const Tilemap &map, int originX, int originY, float budget,
+             const OccupancyGrid *occupancy = nullptr,
+             Entity agent = INVALID_ENTITY);
+  // Grows the budget and settles the tiles that now fit. No-op if smaller.
+  void Extend(float budget);
+  void Clear() {
+    m_Map = nullptr;
+    m_Tiles.clear();
+  }
+
+  bool Contains(int x, int y) const {
+    return InBounds(x, y) && m_Stamp[Index(x, y)] == m_Generation &&
+           m_Cost[Index(x, y)] <= m_Budget;
+  }
+  // Movement spent walking to (x, y); infinity outside the range.
+  float GetCost(int x, int y) const;
+  // Route to (x, y): start exclusive, destination inclusive, like
+  // Pathfinding::FindPath. False outside the range or at the origin.
+  bool ExtractPath(int x, int y, std::vector<std::pair<int, int>> &path) const;
+
+  // Whether the range was built on map, unchanged since, from (x, y).
+  bool IsFrom(const Tilemap &map, int x, int y) const {
+    return m_Map == &map && m_MapRevision == map.GetRevision() &&
+           m_OriginX == x && m_OriginY == y;
+  }
+  float GetBudget() const { return m_Budget; }
+  // Tiles in range, origin first, in order of cost.
+  const std::vector<std::pair<int, int>> &GetTiles() const { return m_Tiles; }
+
+private:
+  bool InBounds(int x, int y) const {
+    return m_Map && x >= 0 && y >= 0 && x < m_Width && y < m_Height;
+  }
+  int Index(int x, int y) const { return y * m_Width + x; }
+
+  void Propagate();
+
+  const Tilemap *m_Map = nullptr;
+  const OccupancyGrid *m_Occupancy = nullptr;
+  Entity m_Agent = INVALID_ENTITY;
+  uint32_t m_MapRevision = 0;
+  int m_Width = 0;
+  int m_Height = 0;
+  int m_OriginX = -1;
+  int m_OriginY = -1;
+  float m_Budget = 0.0f;
+  uint32_t m_Generation = 0;
+  std::vector<uint32_t> m_Stamp; // == m_Generation once a tile is reached
+  std::vector<float> m_Cost;
+  std::vector<int> m_Parent;
+  // Frontier left over when the budget ran out, resumed by Extend
+  std::vector<PathfindingContext::HeapEntry> m_Heap;
+  std::vector<std::pair<int, int>> m_Tiles;
+};
+
+} // namespace PixelsEngine
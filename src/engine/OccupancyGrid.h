@@ -0,0 +1,131 @@
+#pragma once
+#include "Components.h"
+#include "ECS.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace PixelsEngine {
+
+// Which tiles hold a blocking entity (a live creature, say). Kept current
+// from change tracking, so a frame only pays for the entities that moved or
+// changed state; destroyed ones drop out as their transform goes. Entities
+// are filed under the tile their transform truncates to, like the game's
+// other tile lookups; off-grid positions are ignored. The blocks predicate
+// must also turn down entities standing on some other map.
+class OccupancyGrid {
+public:
+  OccupancyGrid() = default;
+  OccupancyGrid(const OccupancyGrid &) = delete;
+  OccupancyGrid &operator=(const OccupancyGrid &) = delete;
+  ~OccupancyGrid() {
+    if (m_Registry)
+      m_Registry->OnDestroy<TransformComponent>().Disconnect(m_Connection);
+  }
+
+  // Listens for destroyed transforms; the registry must outlive the grid.
+  void Attach(Registry &registry) {
+    m_Registry = &registry;
+    m_Connection = registry.OnDestroy<TransformComponent>().Connect(
+        [this](Entity entity) { Remove(entity); });
+  }
+
+  void Resize(int width, int height) {
+    m_Width = width;
+    m_Height = height;
+    m_Counts.assign((size_t)width * height, 0);
+    m_Tiles.clear();
+  }
+
+  // Files every blocking entity from scratch: after Resize, or after a load
+  // or snapshot restore moved entities without marking their transforms.
+  template <typename Blocks> void Rebuild(Registry &registry, Blocks blocks) {
+    std::fill(m_Counts.begin(), m_Counts.end(), 0);
+    m_Tiles.clear();
+    registry.View<TransformComponent>().each(
+        [&](Entity entity, TransformComponent &transform) {
+          if (blocks(entity))
+            Set(entity, (int)transform.x, (int)transform.y);
+        });
+  }
+
+  // Re-files entities whose transform, or any of the Also components the
+  // predicate reads, was added or patched since the last ClearChanges().
+  // Call before Registry::ClearChanges(), with tracking enabled for each.
+  template <typename... Also, typename Blocks>
+  void Update(Registry &registry, Blocks blocks) {
+    auto refile = [&](const std::vector<Entity> &changed) {
+      for (Entity entity : changed) {
+        auto *transform = registry.GetComponent<TransformComponent>(entity);
+        if (transform && blocks(entity))
+          Set(entity, (int)transform->x, (int)transform->y);
+        else
+          Remove(entity);
+      }
+    };
+    refile(registry.Added<TransformComponent>());
+    refile(registry.Updated<TransformComponent>());
+    (refile(registry.Added<Also>()), ...);
+    (refile(registry.Updated<Also>()), ...);
+  }
+
+  void Set(Entity entity, int x, int y) {
+    int tile = InBounds(x, y) ? y * m_Width + x : -1;
+    auto it = m_Tiles.find(entity);
+    if (it != m_Tiles.end()) {
+      if (it->second == tile)
+        return;
+      if (it->second >= 0)
+        --m_Counts[it->second];
+      it->second = tile;
+    } else {
+      m_Tiles.emplace(entity, tile);
+    }
+    if (tile >= 0)
+      ++m_Counts[tile];
+  }
+
+  void Remove(Entity entity) {
+    auto it = m_Tiles.find(entity);
+    if (it == m_Tiles.end())
+      return;
+    if (it->second >= 0)
+      --m_Counts[it->second];
+    m_Tiles.erase(it);
+  }
+
+  // Whether anyone other than ignore stands on the tile.
+  bool IsOccupied(int x, int y, Entity ignore = INVALID_ENTITY) const {
+    if (!InBounds(x, y))
+      return false;
+    int tile = y * m_Width + x;
+    int count = m_Counts[tile];
+    if (count > 0 && ignore != INVALID_ENTITY) {
+      auto it = m_Tiles.find(ignore);
+      if (it != m_Tiles.end() && it->second == tile)
+        --count;
+    }
+    return count > 0;
+  }
+
+  int GetCount(int x, int y) const {
+    return InBounds(x, y) ? m_Counts[y * m_Width + x] : 0;
+  }
+  int GetWidth() const { return m_Width; }
+  int GetHeight() const { return m_Height; }
+
+private:
+  bool InBounds(int x, int y) const {
+    return x >= 0 && y >= 0 && x < m_Width && y < m_Height;
+  }
+
+  int m_Width = 0;
+  int m_Height = 0;
+  std::vector<uint16_t> m_Counts;
+  std::unordered_map<Entity, int> m_Tiles; // tile index, -1 when off-grid
+  Registry *m_Registry = nullptr;
+  size_t m_Connection = 0;
+};
+
+} // namespace PixelsEngine
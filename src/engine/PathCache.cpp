@@ -0,0 +1,91 @@
+#include "PathCache.h"
+#include <algorithm>
+
+namespace PixelsEngine {
+
+bool PathCache::Find(const Tilemap &map, int startX, int startY, int endX,
+                     int endY, std::vector<std::pair<int, int>> &path) {
+  auto it = m_Index.find(Key{&map, startX, startY, endX, endY});
+  if (it == m_Index.end()) {
+    ++m_Stats.misses;
+    return false;
+  }
+  if (!IsValid(map, *it->second)) {
+    m_Entries.erase(it->second);
+    m_Index.erase(it);
+    ++m_Stats.misses;
+    ++m_Stats.invalidations;
+    return false;
+  }
+  m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+  path = it->second->path;
+  ++m_Stats.hits;
+  return true;
+}
+
+void PathCache::Store(const Tilemap &map, int startX, int startY, int endX,
+                      int endY,
+                      const std::vector<std::pair<int, int>> &path) {
+  if (m_Capacity == 0)
+    return;
+  Key key{&map, startX, startY, endX, endY};
+  auto it = m_Index.find(key);
+  if (it != m_Index.end()) {
+    m_Entries.erase(it->second);
+    m_Index.erase(it);
+  }
+
+  Entry entry{key, path, map.GetRevision(), {}};
+  // Smoothed paths run straight between far-apart waypoints, so take every
+  // region under each leg's bounding box rather than just the endpoints.
+  auto addLeg = [&](int x0, int y0, int x1, int y1) {
+    int size = Tilemap::REGION_SIZE;
+    int rx0 = std::max(0, std::min(x0, x1) / size);
+    int ry0 = std::max(0, std::min(y0, y1) / size);
+    int rx1 = std::min(map.GetRegionsX() - 1, std::max(x0, x1) / size);
+    int ry1 = std::min(map.GetRegionsY() - 1, std::max(y0, y1) / size);
+    for (int ry = ry0; ry <= ry1; ++ry) {
+      for (int rx = rx0; rx <= rx1; ++rx) {
+        int region = ry * map.GetRegionsX() + rx;
+        bool known = false;
+        for (auto &entryRegion : entry.regions)
+          known = known || entryRegion.first == region;
+        if (!known)
+          entry.regions.push_back({region, map.GetRegionRevision(rx, ry)});
+      }
+    }
+  };
+  int x = startX, y = startY;
+  for (auto &step : path) {
+    addLeg(x, y, step.first, step.second);
+    x = step.first;
+    y = step.second;
+  }
+
+  m_Entries.push_front(std::move(entry));
+  m_Index[key] = m_Entries.begin();
+  while (m_Entries.size() > m_Capacity) {
+    m_Index.erase(m_Entries.back().key);
+    m_Entries.pop_back();
+    ++m_Stats.evictions;
+  }
+}
+
+bool PathCache::IsValid(const Tilemap &map, Entry &entry) const {
+  if (entry.mapRevision == map.GetRevision())
+    return true;
+  // A failed search could be fixed by an edit anywhere.
+  if (entry.path.empty())
+    return false;
+  int regionsX = map.GetRegionsX();
+  for (auto &region : entry.regions) {
+    if (map.GetRegionRevision(region.first % regionsX,
+                              region.first / regionsX) != region.second)
+      return false;
+  }
+  // Still good: skip the region walk next time until the map changes again.
+  entry.mapRevision = map.GetRevision();
+  return true;
+}
+
+} // namespace PixelsEngine
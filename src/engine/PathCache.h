@@ -0,0 +1,81 @@
+#pragma once
+#include "Tilemap.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PixelsEngine {
+
+// LRU cache of search results keyed on (map, start, goal). Each entry
+// remembers the revision of every tilemap region its path crosses, so an
+// edit only evicts the paths running through the edited region; a path that
+// survives stays walkable, though a newly opened shortcut elsewhere is not
+// noticed. Failed searches are kept until the map's walkability changes at
+// all. Main thread only.
+class PathCache {
+public:
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t invalidations = 0; // misses caused by a changed region
+    uint64_t evictions = 0;     // entries dropped for capacity
+  };
+
+  explicit PathCache(size_t capacity = 256) : m_Capacity(capacity) {}
+
+  // Copies out a still-valid cached result. Returns false on a miss.
+  bool Find(const Tilemap &map, int startX, int startY, int endX, int endY,
+            std::vector<std::pair<int, int>> &path);
+  // Records a search made against the map's current walkability.
+  void Store(const Tilemap &map, int startX, int startY, int endX, int endY,
+             const std::vector<std::pair<int, int>> &path);
+
+  void Clear() {
+    m_Entries.clear();
+    m_Index.clear();
+  }
+  size_t GetSize() const { return m_Entries.size(); }
+  const Stats &GetStats() const { return m_Stats; }
+  void ResetStats() { m_Stats = Stats(); }
+
+private:
+  struct Key {
+    const Tilemap *map;
+    int startX, startY, endX, endY;
+    bool operator==(const Key &other) const {
+      return map == other.map && startX == other.startX &&
+             startY == other.startY && endX == other.endX &&
+             endY == other.endY;
+    }
+  };
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      size_t h = std::hash<const void *>()(key.map);
+      for (int v : {key.startX, key.startY, key.endX, key.endY})
+        h = h * 31 + std::hash<int>()(v);
+      return h;
+    }
+  };
+  struct Entry {
+    Key key;
+    std::vector<std::pair<int, int>> path;
+    uint32_t mapRevision;
+    // (region index, revision) for each region the path touches
+    std::vector<std::pair<int, uint32_t>> regions;
+  };
+  using EntryList = std::list<Entry>;
+
+  bool IsValid(const Tilemap &map, Entry &entry) const;
+
+  size_t m_Capacity;
+  EntryList m_Entries; // most recently used first
+  std::unordered_map<Key, EntryList::iterator, KeyHash> m_Index;
+  Stats m_Stats;
+};
+
+} // namespace PixelsEngine
@@ -0,0 +1,181 @@
+#include "PathRequestQueue.h"
+#include "Components.h"
+#include <algorithm>
+
+namespace PixelsEngine {
+
+PathRequestQueue::~PathRequestQueue() {
+  for (auto &request : m_Running) {
+    request->cancelled = true;
+    m_Jobs.Wait(request->done);
+  }
+}
+
+PathTicket PathRequestQueue::Submit(const Tilemap &map, Entity entity,
+                                    int startX, int startY, int endX,
+                                    int endY, PathAlgorithm algorithm) {
+  CancelFor(entity);
+  PathTicket ticket =
+      Enqueue(map, entity, startX, startY, endX, endY, algorithm);
+  m_EntityTickets[entity] = ticket;
+  return ticket;
+}
+
+PathTicket PathRequestQueue::Submit(const Tilemap &map, int startX,
+                                    int startY, int endX, int endY,
+                                    PathAlgorithm algorithm) {
+  return Enqueue(map, INVALID_ENTITY, startX, startY, endX, endY, algorithm);
+}
+
+void PathRequestQueue::Cancel(PathTicket ticket) {
+  m_Results.erase(ticket);
+  auto it = m_Requests.find(ticket);
+  if (it == m_Requests.end())
+    return;
+  // The queue and running list still hold it; they skip cancelled ones.
+  it->second->cancelled = true;
+  Entity entity = it->second->entity;
+  if (entity != INVALID_ENTITY)
+    m_EntityTickets.erase(entity);
+  m_Requests.erase(it);
+}
+
+void PathRequestQueue::CancelFor(Entity entity) {
+  auto it = m_EntityTickets.find(entity);
+  if (it != m_EntityTickets.end())
+    Cancel(it->second);
+}
+
+void PathRequestQueue::CancelAll() {
+  for (auto &request : m_Requests)
+    request.second->cancelled = true;
+  m_Requests.clear();
+  m_EntityTickets.clear();
+  m_Results.clear();
+}
+
+void PathRequestQueue::Update(Registry &registry) {
+  Deliver(registry);
+  int started = 0;
+  while (started < m_SearchesPerFrame && !m_Queued.empty()) {
+    std::shared_ptr<Request> request = std::move(m_Queued.front());
+    m_Queued.pop_front();
+    if (request->cancelled)
+      continue;
+    Start(request);
+    ++started;
+  }
+  // Without workers the searches ran inline, so hand them over right away.
+  Deliver(registry);
+}
+
+bool PathRequestQueue::Take(PathTicket ticket,
+                            std::vector<std::pair<int, int>> &path) {
+  path.clear();
+  if (IsPending(ticket))
+    return false;
+  // Cancelled or unknown tickets read as finished with no path, so callers
+  // polling a dropped request do not wait forever.
+  auto it = m_Results.find(ticket);
+  if (it != m_Results.end()) {
+    path = std::move(it->second);
+    m_Results.erase(it);
+  }
+  return true;
+}
+
+PathTicket PathRequestQueue::Enqueue(const Tilemap &map, Entity entity,
+                                     int startX, int startY, int endX,
+                                     int endY, PathAlgorithm algorithm) {
+  if (++m_NextTicket == INVALID_TICKET)
+    ++m_NextTicket;
+  auto request = std::make_shared<Request>();
+  request->ticket = m_NextTicket;
+  request->entity = entity;
+  request->source = &map;
+  request->map = SnapshotOf(map);
+  request->startX = startX;
+  request->startY = startY;
+  request->endX = endX;
+  request->endY = endY;
+  request->algorithm = algorithm;
+  request->smooth = m_Smooth;
+  m_Requests[request->ticket] = request;
+  // A cache hit never runs; its counter is already drained, so the next
+  // Deliver() hands it over without spending the search budget.
+  if (m_Cache &&
+      m_Cache->Find(map, startX, startY, endX, endY, request->path)) {
+    request->cached = true;
+    m_Running.push_back(std::move(request));
+  } else {
+    m_Queued.push_back(std::move(request));
+  }
+  return m_NextTicket;
+}
+
+std::shared_ptr<const WalkabilitySnapshot>
+PathRequestQueue::SnapshotOf(const Tilemap &map) {
+  if (m_SnapshotSource != &map || !m_Snapshot ||
+      m_Snapshot->GetRevision() != map.GetRevision()) {
+    m_Snapshot = std::make_shared<const WalkabilitySnapshot>(map);
+    m_SnapshotSource = &map;
+  }
+  return m_Snapshot;
+}
+
+void PathRequestQueue::Start(const std::shared_ptr<Request> &request) {
+  m_Running.push_back(request);
+  // m_Running keeps the request alive until its counter drains.
+  Request *raw = request.get();
+  m_Jobs.RunBackground(
+      [raw]() {
+        if (raw->cancelled)
+          return;
+        thread_local PathfindingContext context;
+        Pathfinding::FindPath(context, *raw->map, raw->startX, raw->startY,
+                              raw->endX, raw->endY, raw->path,
+                              raw->algorithm);
+        if (raw->smooth)
+          Pathfinding::SmoothPath(*raw->map, raw->startX, raw->startY,
+                                  raw->path);
+      },
+      &raw->done);
+}
+
+void PathRequestQueue::Deliver(Registry &registry) {
+  auto finished = std::stable_partition(
+      m_Running.begin(), m_Running.end(),
+      [](const std::shared_ptr<Request> &request) {
+        return !request->done.IsDone();
+      });
+  for (auto it = finished; it != m_Running.end(); ++it) {
+    Request &request = **it;
+    // Already drained; this only syncs with the worker's last touch of the
+    // counter so the request can be freed below.
+    m_Jobs.Wait(request.done);
+    if (request.cancelled)
+      continue;
+    m_Requests.erase(request.ticket);
+    // Only results for the walkability the map still has are worth keeping.
+    if (m_Cache && !request.cached &&
+        request.map->GetRevision() == request.source->GetRevision())
+      m_Cache->Store(*request.source, request.startX, request.startY,
+                     request.endX, request.endY, request.path);
+    if (request.entity == INVALID_ENTITY) {
+      m_Results[request.ticket] = std::move(request.path);
+      continue;
+    }
+    m_EntityTickets.erase(request.entity);
+    auto *move = registry.GetComponent<PathMovementComponent>(request.entity);
+    if (!move || request.path.empty())
+      continue;
+    move->path = std::move(request.path);
+    move->currentPathIndex = 0;
+    move->isMoving = true;
+    move->targetX = (float)move->path[0].first;
+    move->targetY = (float)move->path[0].second;
+  }
+  m_Running.erase(finished, m_Running.end());
+}
+
+} // namespace PixelsEngine
@@ -0,0 +1,104 @@
+#pragma once
+#include "ECS.h"
+#include "JobSystem.h"
+#include "PathCache.h"
+#include "Pathfinding.h"
+#include "WalkabilitySnapshot.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PixelsEngine {
+
+using PathTicket = uint32_t;
+const PathTicket INVALID_TICKET = 0;
+
+// Runs path searches on the job system instead of inside the frame. Requests
+// are queued by ticket; Update() (main thread, once per frame) starts at most
+// a budget of them, each against a walkability snapshot of its map, and
+// hands finished paths back. Requests made for an entity are delivered to
+// its PathMovementComponent and supersede that entity's older requests;
+// the others wait for Take(). With a cache set, repeated routes skip the
+// search and finished searches are recorded.
+class PathRequestQueue {
+public:
+  explicit PathRequestQueue(JobSystem &jobs, int searchesPerFrame = 4)
+      : m_Jobs(jobs), m_SearchesPerFrame(searchesPerFrame) {}
+  // Waits for searches still running on workers.
+  ~PathRequestQueue();
+
+  PathRequestQueue(const PathRequestQueue &) = delete;
+  PathRequestQueue &operator=(const PathRequestQueue &) = delete;
+
+  PathTicket Submit(const Tilemap &map, Entity entity, int startX, int startY,
+                    int endX, int endY,
+                    PathAlgorithm algorithm = PathAlgorithm::JumpPoint);
+  PathTicket Submit(const Tilemap &map, int startX, int startY, int endX,
+                    int endY,
+                    PathAlgorithm algorithm = PathAlgorithm::JumpPoint);
+
+  // Drops a request; a search already running finishes but is discarded.
+  void Cancel(PathTicket ticket);
+  void CancelFor(Entity entity);
+  // Drops every request and undelivered result, e.g. when the world they
+  // were made against has been rolled back.
+  void CancelAll();
+
+  void Update(Registry &registry);
+
+  // Not owned; nullptr disables caching.
+  void SetCache(PathCache *cache) { m_Cache = cache; }
+  // String-pull results down to their corners on the worker (off by default).
+  void SetSmoothing(bool smooth) { m_Smooth = smooth; }
+
+  // Queued or running, not yet delivered.
+  bool IsPending(PathTicket ticket) const {
+    return m_Requests.count(ticket) != 0;
+  }
+  // Moves out a finished result for a request made without an entity.
+  // Returns false while it is pending; an empty path means none was found.
+  bool Take(PathTicket ticket, std::vector<std::pair<int, int>> &path);
+
+private:
+  struct Request {
+    PathTicket ticket;
+    Entity entity;
+    const Tilemap *source;
+    std::shared_ptr<const WalkabilitySnapshot> map;
+    int startX, startY, endX, endY;
+    PathAlgorithm algorithm;
+    bool smooth;
+    bool cached = false; // answered by the cache, never searched
+    std::atomic<bool> cancelled{false};
+    std::vector<std::pair<int, int>> path; // written by the worker
+    JobCounter done;
+  };
+
+  PathTicket Enqueue(const Tilemap &map, Entity entity, int startX,
+                     int startY, int endX, int endY, PathAlgorithm algorithm);
+  std::shared_ptr<const WalkabilitySnapshot> SnapshotOf(const Tilemap &map);
+  void Start(const std::shared_ptr<Request> &request);
+  void Deliver(Registry &registry);
+
+  JobSystem &m_Jobs;
+  int m_SearchesPerFrame;
+  PathCache *m_Cache = nullptr;
+  bool m_Smooth = false;
+  PathTicket m_NextTicket = INVALID_TICKET;
+  std::unordered_map<PathTicket, std::shared_ptr<Request>> m_Requests;
+  std::unordered_map<Entity, PathTicket> m_EntityTickets;
+  std::deque<std::shared_ptr<Request>> m_Queued;
+  std::vector<std::shared_ptr<Request>> m_Running;
+  std::unordered_map<PathTicket, std::vector<std::pair<int, int>>> m_Results;
+
+  // Rebuilt when the map or its walkability revision changes; running
+  // searches keep the copy they started with.
+  const Tilemap *m_SnapshotSource = nullptr;
+  std::shared_ptr<const WalkabilitySnapshot> m_Snapshot;
+};
+
+} // namespace PixelsEngine
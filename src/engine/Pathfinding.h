@@ -1,139 +1,473 @@
 #pragma once
 #include "Tilemap.h"
 #include <algorithm>
+#include <climits>
 #include <cmath>
-#include <queue>
-#include <unordered_map>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
 #include <vector>
 
 namespace PixelsEngine {
 
-struct Node {
-  int x, y;
-  float gCost, hCost;
-  Node *parent;
+// Scratch state for graph searches, sized to the largest map seen so far.
+// Per-tile entries are only trusted when their stamp matches the current
+// search, so starting a search is O(1) instead of clearing every array, and
+// once warmed up a search makes no heap allocations.
+class PathfindingContext {
+public:
+  struct HeapEntry {
+    float fCost;
+    int tile;
+    bool operator>(const HeapEntry &other) const { return fCost > other.fCost; }
+  };
+
+  template <typename Map> void Begin(const Map &map) {
+    m_Width = map.GetWidth();
+    m_Height = map.GetHeight();
+    Reset((size_t)m_Width * m_Height);
+  }
+
+  // Starts a search over nodeCount abstract nodes (no grid layout).
+  void Reset(size_t nodeCount) {
+    if (m_Stamp.size() < nodeCount) {
+      m_GCost.resize(nodeCount);
+      m_Parent.resize(nodeCount);
+      m_Stamp.resize(nodeCount, 0);
+      m_Closed.resize(nodeCount, 0);
+    }
+    if (++m_Search == 0) {
+      // Stamps wrapped; forget every stale entry once.
+      std::fill(m_Stamp.begin(), m_Stamp.end(), 0);
+      std::fill(m_Closed.begin(), m_Closed.end(), 0);
+      m_Search = 1;
+    }
+    m_Heap.clear();
+  }
+
+  int GetWidth() const { return m_Width; }
+  bool InBounds(int x, int y) const {
+    return x >= 0 && y >= 0 && x < m_Width && y < m_Height;
+  }
+  int Index(int x, int y) const { return y * m_Width + x; }
+
+  bool IsSeen(int tile) const { return m_Stamp[tile] == m_Search; }
+  bool IsClosed(int tile) const { return m_Closed[tile] == m_Search; }
+  void Close(int tile) { m_Closed[tile] = m_Search; }
+  float GetCost(int tile) const { return m_GCost[tile]; }
+  int GetParent(int tile) const { return m_Parent[tile]; }
 
-  float fCost() const { return gCost + hCost; }
+  // Records a (better) route to tile and queues it.
+  void Open(int tile, float gCost, int parent, float hCost) {
+    m_Stamp[tile] = m_Search;
+    m_GCost[tile] = gCost;
+    m_Parent[tile] = parent;
+    m_Heap.push_back({gCost + hCost, tile});
+    std::push_heap(m_Heap.begin(), m_Heap.end(), std::greater<HeapEntry>());
+  }
+
+  bool Empty() const { return m_Heap.empty(); }
+
+  HeapEntry Pop() {
+    std::pop_heap(m_Heap.begin(), m_Heap.end(), std::greater<HeapEntry>());
+    HeapEntry top = m_Heap.back();
+    m_Heap.pop_back();
+    return top;
+  }
+
+private:
+  int m_Width = 0;
+  int m_Height = 0;
+  uint32_t m_Search = 0;
+  std::vector<float> m_GCost;
+  std::vector<int> m_Parent;
+  std::vector<uint32_t> m_Stamp;  // m_Search when g-cost/parent are valid
+  std::vector<uint32_t> m_Closed; // m_Search once the tile is expanded
+  std::vector<HeapEntry> m_Heap;
+};
 
-  bool operator>(const Node &other) const { return fCost() > other.fCost(); }
+enum class PathAlgorithm {
+  AStar,
+  // Jump Point Search: same path cost as A* on our uniform-cost grids, but
+  // only expands tiles where the optimal route can turn.
+  JumpPoint
 };
 
 class Pathfinding {
 public:
+  static constexpr float STRAIGHT_COST = 1.0f;
+  static constexpr float DIAGONAL_COST = 1.414f;
+  static constexpr int MAX_NODES = 5000;
+
+  // Path from start (exclusive) to end (inclusive); empty when the end is
+  // blocked, equal to the start, or not reached within MAX_NODES expansions.
+  // Uses a per-thread context. Map is a Tilemap, or anything else with its
+  // GetWidth/GetHeight/IsWalkable, such as a WalkabilitySnapshot.
+  template <typename Map>
   static std::vector<std::pair<int, int>>
-  FindPath(const Tilemap &map, int startX, int startY, int endX, int endY) {
+  FindPath(const Map &map, int startX, int startY, int endX, int endY,
+           PathAlgorithm algorithm = PathAlgorithm::AStar) {
+    thread_local PathfindingContext context;
     std::vector<std::pair<int, int>> path;
+    FindPath(context, map, startX, startY, endX, endY, path, algorithm);
+    return path;
+  }
 
+  // Same, with an explicit context and output buffer so repeated searches
+  // reuse their memory. Returns whether a path was found.
+  template <typename Map>
+  static bool FindPath(PathfindingContext &context, const Map &map,
+                       int startX, int startY, int endX, int endY,
+                       std::vector<std::pair<int, int>> &path,
+                       PathAlgorithm algorithm = PathAlgorithm::AStar) {
+    path.clear();
     if (!map.IsWalkable(endX, endY))
-      return path;
-
+      return false;
     if (startX == endX && startY == endY)
-      return path;
+      return false;
 
-    struct NodePtr {
-        Node* node;
-        float fCost; // Store fCost at time of queuing
-        bool operator>(const NodePtr& other) const { return fCost > other.fCost; }
-    };
+    context.Begin(map);
+    if (!context.InBounds(startX, startY))
+      return false;
+    // Walled-off goals would otherwise cost MAX_NODES expansions to reject.
+    if (!IsReachable(map, startX, startY, endX, endY))
+      return false;
 
-    std::priority_queue<NodePtr, std::vector<NodePtr>, std::greater<NodePtr>> openSet;
-    std::unordered_map<int, Node*> allNodes;
+    if (algorithm == PathAlgorithm::JumpPoint)
+      return SearchJumpPoint(context, map, startX, startY, endX, endY, path);
+    return SearchAStar(context, map, startX, startY, endX, endY, path);
+  }
 
-    auto GetKey = [](int x, int y) { return x * 10000 + y; };
+  // Whether any path joins the two tiles, in O(1) through the map's area
+  // labels. A blocked start (say, an actor standing on a prop) counts as
+  // connected to every area it could step into.
+  template <typename Map>
+  static bool IsReachable(const Map &map, int startX, int startY, int endX,
+                          int endY) {
+    int area = map.GetArea(endX, endY);
+    if (area < 0)
+      return false;
+    if (map.IsWalkable(startX, startY))
+      return map.GetArea(startX, startY) == area;
+    for (int dy = -1; dy <= 1; ++dy)
+      for (int dx = -1; dx <= 1; ++dx)
+        if (map.GetArea(startX + dx, startY + dy) == area)
+          return true;
+    return false;
+  }
 
-    Node* startNode = new Node{startX, startY, 0, Heuristic(startX, startY, endX, endY), nullptr};
-    allNodes[GetKey(startX, startY)] = startNode;
-    openSet.push({startNode, startNode->fCost()});
+  // The tile nearest (x, y) that is reachable from start, searching out to
+  // maxRadius tiles; (x, y) itself when it already is. For clicks on water,
+  // rocks or walled-off ground.
+  template <typename Map>
+  static bool NearestReachable(const Map &map, int startX, int startY, int x,
+                               int y, int maxRadius, int &outX, int &outY) {
+    int bestDistance = -1;
+    for (int radius = 0; radius <= maxRadius; ++radius) {
+      // Tiles on later rings are at least radius away.
+      if (bestDistance >= 0 && radius * radius > bestDistance)
+        break;
+      for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+          if (std::max(std::abs(dx), std::abs(dy)) != radius)
+            continue;
+          int distance = dx * dx + dy * dy;
+          if (bestDistance >= 0 && distance >= bestDistance)
+            continue;
+          if (!IsReachable(map, startX, startY, x + dx, y + dy))
+            continue;
+          bestDistance = distance;
+          outX = x + dx;
+          outY = y + dy;
+        }
+      }
+    }
+    return bestDistance >= 0;
+  }
 
-    int nodesProcessed = 0;
-    const int MAX_NODES = 5000; 
+  // Whether walking straight between the centres of two tiles stays on
+  // walkable ground. Visits every tile the segment crosses (Amanatides-Woo
+  // traversal in integer form); where it passes exactly through a corner,
+  // both side tiles must be walkable, so straight runs never clip a rock.
+  // The start tile itself is not checked.
+  template <typename Map>
+  static bool HasLineOfSight(const Map &map, int x0, int y0, int x1,
+                             int y1) {
+    int dx = std::abs(x1 - x0);
+    int dy = std::abs(y1 - y0);
+    int stepX = Sign(x1 - x0);
+    int stepY = Sign(y1 - y0);
+    // Parameter of the next vertical/horizontal grid line, scaled by
+    // 2 * dx * dy so every value stays integral.
+    long long nextX = dx == 0 ? LLONG_MAX : dy;
+    long long nextY = dy == 0 ? LLONG_MAX : dx;
+    int x = x0, y = y0;
+    for (int remaining = dx + dy; remaining > 0;) {
+      if (nextX < nextY) {
+        x += stepX;
+        nextX += 2LL * dy;
+        --remaining;
+      } else if (nextY < nextX) {
+        y += stepY;
+        nextY += 2LL * dx;
+        --remaining;
+      } else {
+        if (!map.IsWalkable(x + stepX, y) || !map.IsWalkable(x, y + stepY))
+          return false;
+        x += stepX;
+        y += stepY;
+        nextX += 2LL * dy;
+        nextY += 2LL * dx;
+        remaining -= 2;
+      }
+      if (!map.IsWalkable(x, y))
+        return false;
+    }
+    return true;
+  }
 
-    while (!openSet.empty() && nodesProcessed < MAX_NODES) {
-      NodePtr currentPtr = openSet.top();
-      openSet.pop();
-      Node* current = currentPtr.node;
+  // String-pulls a FindPath result down to its corners: every waypoint the
+  // last kept one can see past is dropped. Same format as FindPath, and the
+  // straight runs between the kept waypoints are never longer.
+  template <typename Map>
+  static void SmoothPath(const Map &map, int startX, int startY,
+                         std::vector<std::pair<int, int>> &path) {
+    if (path.size() < 2)
+      return;
+    std::pair<int, int> anchor{startX, startY};
+    size_t kept = 0;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+      if (HasLineOfSight(map, anchor.first, anchor.second, path[i + 1].first,
+                         path[i + 1].second))
+        continue;
+      anchor = path[i];
+      path[kept++] = path[i];
+    }
+    path[kept++] = path.back();
+    path.resize(kept);
+  }
 
-      // If we found a better path to this node since it was queued, skip this entry
-      if (currentPtr.fCost > current->fCost()) continue;
+  // Octile distance: exact cost on an open 8-connected grid.
+  static float Heuristic(int x1, int y1, int x2, int y2) {
+    int dx = std::abs(x1 - x2);
+    int dy = std::abs(y1 - y2);
+    return STRAIGHT_COST * (dx + dy) +
+           (DIAGONAL_COST - 2.0f * STRAIGHT_COST) * std::min(dx, dy);
+  }
 
+private:
+  template <typename Map>
+  static bool SearchAStar(PathfindingContext &context, const Map &map,
+                          int startX, int startY, int endX, int endY,
+                          std::vector<std::pair<int, int>> &path) {
+    static const int dx[] = {0, 0, -1, 1, -1, -1, 1, 1}; // 8-directional
+    static const int dy[] = {-1, 1, 0, 0, -1, 1, -1, 1};
+
+    int width = context.GetWidth();
+    int start = context.Index(startX, startY);
+    int end = context.Index(endX, endY);
+    context.Open(start, 0.0f, -1, Heuristic(startX, startY, endX, endY));
+
+    int nodesProcessed = 0;
+    while (!context.Empty() && nodesProcessed < MAX_NODES) {
+      int current = context.Pop().tile;
+      // Later, cheaper routes re-queue a tile; skip the stale entries.
+      if (context.IsClosed(current))
+        continue;
+      context.Close(current);
       nodesProcessed++;
 
-      if (current->x == endX && current->y == endY) {
-        RetracePath(startNode, current, path);
-        for (auto& pair : allNodes) delete pair.second;
-        return path;
+      if (current == end) {
+        RetracePath(context, start, end, path);
+        return true;
       }
 
-      int dx[] = {0, 0, -1, 1, -1, -1, 1, 1}; // 8-directional
-      int dy[] = {-1, 1, 0, 0, -1, 1, -1, 1};
-
+      int cx = current % width;
+      int cy = current / width;
       for (int i = 0; i < 8; ++i) {
-        int nx = current->x + dx[i];
-        int ny = current->y + dy[i];
-
-        if (!map.IsWalkable(nx, ny)) continue;
-
-        float moveCost = (i < 4) ? 1.0f : 1.414f;
-        float gScore = current->gCost + moveCost;
-        int key = GetKey(nx, ny);
-
-        if (allNodes.find(key) == allNodes.end() || gScore < allNodes[key]->gCost) {
-            if (allNodes.find(key) == allNodes.end()) {
-                Node* neighbor = new Node{nx, ny, gScore, Heuristic(nx, ny, endX, endY), current};
-                allNodes[key] = neighbor;
-                openSet.push({neighbor, neighbor->fCost()});
-            } else {
-                allNodes[key]->gCost = gScore;
-                allNodes[key]->parent = current;
-                openSet.push({allNodes[key], allNodes[key]->fCost()});
-            }
-        }
+        int nx = cx + dx[i];
+        int ny = cy + dy[i];
+        if (!map.IsWalkable(nx, ny))
+          continue;
+
+        int neighbor = context.Index(nx, ny);
+        if (context.IsClosed(neighbor))
+          continue;
+        float gCost = context.GetCost(current) +
+                      ((i < 4) ? STRAIGHT_COST : DIAGONAL_COST);
+        if (!context.IsSeen(neighbor) || gCost < context.GetCost(neighbor))
+          context.Open(neighbor, gCost, current,
+                       Heuristic(nx, ny, endX, endY));
       }
     }
-
-    for (auto& pair : allNodes) delete pair.second;
-    return path;
+    return false;
   }
 
-private:
-  static float Heuristic(int x1, int y1, int x2, int y2) {
-    // Manhattan distance for 4-way movement
-    return std::abs(x1 - x2) + std::abs(y1 - y2);
+  // Same expansion loop as A*, but successors are the jump points found by
+  // scanning along each pruned direction, and the path is re-expanded into
+  // single steps at the end. Diagonals may cut corners, like A*'s moves.
+  template <typename Map>
+  static bool SearchJumpPoint(PathfindingContext &context, const Map &map,
+                              int startX, int startY, int endX, int endY,
+                              std::vector<std::pair<int, int>> &path) {
+    int width = context.GetWidth();
+    int start = context.Index(startX, startY);
+    int end = context.Index(endX, endY);
+    context.Open(start, 0.0f, -1, Heuristic(startX, startY, endX, endY));
+
+    int nodesProcessed = 0;
+    while (!context.Empty() && nodesProcessed < MAX_NODES) {
+      int current = context.Pop().tile;
+      if (context.IsClosed(current))
+        continue;
+      context.Close(current);
+      nodesProcessed++;
+
+      if (current == end) {
+        RetraceJumps(context, start, end, path);
+        return true;
+      }
+
+      int cx = current % width;
+      int cy = current / width;
+      int directions[8][2];
+      int count = PrunedDirections(context, map, current, cx, cy, directions);
+      for (int i = 0; i < count; ++i) {
+        int jx, jy;
+        if (!Jump(map, cx, cy, directions[i][0], directions[i][1], endX, endY,
+                  jx, jy))
+          continue;
+        int jump = context.Index(jx, jy);
+        if (context.IsClosed(jump))
+          continue;
+        float gCost = context.GetCost(current) + Heuristic(cx, cy, jx, jy);
+        if (!context.IsSeen(jump) || gCost < context.GetCost(jump))
+          context.Open(jump, gCost, current, Heuristic(jx, jy, endX, endY));
+      }
+    }
+    return false;
   }
 
-  static void RetracePath(Node *startNode, Node *endNode,
-                          std::vector<std::pair<int, int>> &path) {
-    Node *current = endNode;
-    int safety = 0;
-    while (current != startNode && current != nullptr && safety < 1000) {
-      path.push_back({current->x, current->y});
-      current = current->parent;
-      safety++;
+  static int Sign(int v) { return (v > 0) - (v < 0); }
+
+  // Directions worth scanning from a jump point reached from its parent:
+  // the natural ones plus any forced by an adjacent obstacle.
+  template <typename Map>
+  static int PrunedDirections(const PathfindingContext &context,
+                              const Map &map, int tile, int x, int y,
+                              int (&out)[8][2]) {
+    int count = 0;
+    auto add = [&](int dx, int dy) {
+      out[count][0] = dx;
+      out[count][1] = dy;
+      ++count;
+    };
+
+    int parent = context.GetParent(tile);
+    if (parent == -1) {
+      for (int dy = -1; dy <= 1; ++dy)
+        for (int dx = -1; dx <= 1; ++dx)
+          if (dx != 0 || dy != 0)
+            add(dx, dy);
+      return count;
     }
-    std::reverse(path.begin(), path.end());
+
+    int width = context.GetWidth();
+    int dx = Sign(x - parent % width);
+    int dy = Sign(y - parent / width);
+    if (dx != 0 && dy != 0) {
+      add(dx, dy);
+      add(dx, 0);
+      add(0, dy);
+      if (!map.IsWalkable(x - dx, y))
+        add(-dx, dy);
+      if (!map.IsWalkable(x, y - dy))
+        add(dx, -dy);
+    } else if (dx != 0) {
+      add(dx, 0);
+      if (!map.IsWalkable(x, y + 1))
+        add(dx, 1);
+      if (!map.IsWalkable(x, y - 1))
+        add(dx, -1);
+    } else {
+      add(0, dy);
+      if (!map.IsWalkable(x + 1, y))
+        add(1, dy);
+      if (!map.IsWalkable(x - 1, y))
+        add(-1, dy);
+    }
+    return count;
   }
 
-  static bool IsInList(const std::vector<Node *> &list, int x, int y) {
-    for (auto *node : list) {
-      if (node->x == x && node->y == y)
+  template <typename Map>
+  static bool HasForcedNeighbor(const Map &map, int x, int y, int dx,
+                                int dy) {
+    if (dx != 0 && dy != 0)
+      return (!map.IsWalkable(x - dx, y) && map.IsWalkable(x - dx, y + dy)) ||
+             (!map.IsWalkable(x, y - dy) && map.IsWalkable(x + dx, y - dy));
+    if (dx != 0)
+      return (!map.IsWalkable(x, y + 1) && map.IsWalkable(x + dx, y + 1)) ||
+             (!map.IsWalkable(x, y - 1) && map.IsWalkable(x + dx, y - 1));
+    return (!map.IsWalkable(x + 1, y) && map.IsWalkable(x + 1, y + dy)) ||
+           (!map.IsWalkable(x - 1, y) && map.IsWalkable(x - 1, y + dy));
+  }
+
+  // Steps from (x, y) in direction (dx, dy) until it reaches the goal, a tile
+  // with a forced neighbour, or (diagonally) a tile whose straight scans find
+  // one. Fails on hitting a wall or the map edge.
+  template <typename Map>
+  static bool Jump(const Map &map, int x, int y, int dx, int dy, int endX,
+                   int endY, int &outX, int &outY) {
+    while (true) {
+      x += dx;
+      y += dy;
+      if (!map.IsWalkable(x, y))
+        return false;
+      if ((x == endX && y == endY) || HasForcedNeighbor(map, x, y, dx, dy)) {
+        outX = x;
+        outY = y;
         return true;
+      }
+      if (dx != 0 && dy != 0) {
+        int ignoredX, ignoredY;
+        if (Jump(map, x, y, dx, 0, endX, endY, ignoredX, ignoredY) ||
+            Jump(map, x, y, 0, dy, endX, endY, ignoredX, ignoredY)) {
+          outX = x;
+          outY = y;
+          return true;
+        }
+      }
     }
-    return false;
   }
 
-  static Node *GetFromList(const std::vector<Node *> &list, int x, int y) {
-    for (auto *node : list) {
-      if (node->x == x && node->y == y)
-        return node;
+  // Jump points are joined by straight or diagonal runs; fill in each step.
+  static void RetraceJumps(const PathfindingContext &context, int start,
+                           int end, std::vector<std::pair<int, int>> &path) {
+    int width = context.GetWidth();
+    for (int tile = end; tile != start && tile != -1;) {
+      int parent = context.GetParent(tile);
+      int x = tile % width, y = tile / width;
+      int px = parent % width, py = parent / width;
+      int dx = Sign(px - x), dy = Sign(py - y);
+      while (x != px || y != py) {
+        path.push_back({x, y});
+        if (x != px)
+          x += dx;
+        if (y != py)
+          y += dy;
+      }
+      tile = parent;
     }
-    return nullptr;
+    std::reverse(path.begin(), path.end());
   }
 
-  static void Cleanup(std::vector<Node *> &open, std::vector<Node *> &closed) {
-    for (auto *n : open)
-      delete n;
-    for (auto *n : closed)
-      delete n;
+  static void RetracePath(const PathfindingContext &context, int start,
+                          int end, std::vector<std::pair<int, int>> &path) {
+    int width = context.GetWidth();
+    for (int tile = end; tile != start && tile != -1;
+         tile = context.GetParent(tile))
+      path.push_back({tile % width, tile / width});
+    std::reverse(path.begin(), path.end());
   }
 };
 
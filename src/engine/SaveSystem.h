@@ -76,7 +76,7 @@ public:
     file << "[QUESTS]\n";
     auto &quests = registry.View<QuestComponent>();
     file << quests.size() << "\n";
-    for (auto &[entity, quest] : quests) {
+    for (auto [entity, quest] : quests) {
       file << quest.questId << " " << quest.state << "\n";
     }
     if (file.fail())
@@ -87,14 +87,14 @@ public:
     file << "[WORLD_ENTITIES]\n";
     auto &transforms = registry.View<TransformComponent>();
     int entityCount = 0;
-    for (auto &[entity, trans] : transforms) {
+    for (auto [entity, trans] : transforms) {
       if (entity != player)
         entityCount++;
     }
     std::cout << "Entity Count: " << entityCount << std::endl;
     file << entityCount << "\n";
 
-    for (auto &[entity, trans] : transforms) {
+    for (auto [entity, trans] : transforms) {
       if (entity == player)
         continue;
 
@@ -251,6 +251,7 @@ public:
       } else if (line == "[PLAYER_TRANSFORM]") {
         if (auto *trans = registry.GetComponent<TransformComponent>(player)) {
           file >> trans->x >> trans->y;
+          registry.Patch<TransformComponent>(player);
         }
       } else if (line == "[PLAYER_STATS]") {
         if (auto *stats = registry.GetComponent<StatsComponent>(player)) {
@@ -320,7 +321,7 @@ public:
           questStates[id] = state;
         }
         auto &quests = registry.View<QuestComponent>();
-        for (auto &[entity, quest] : quests) {
+        for (auto [entity, quest] : quests) {
           if (questStates.find(quest.questId) != questStates.end()) {
             quest.state = questStates[quest.questId];
           }
@@ -335,7 +336,7 @@ public:
         std::unordered_map<std::string, Entity> existingEntitiesById;
         std::vector<Entity> genericEntities;
 
-        for (auto &[ent, t] : worldTransforms) {
+        for (auto [ent, t] : worldTransforms) {
           if (ent == player)
             continue;
           if (auto *inter = registry.GetComponent<InteractionComponent>(ent)) {
@@ -374,6 +375,7 @@ public:
             if (auto *t = registry.GetComponent<TransformComponent>(target)) {
               t->x = ex;
               t->y = ey;
+              registry.Patch<TransformComponent>(target);
             }
             if (auto *inter =
                     registry.GetComponent<InteractionComponent>(target)) {
@@ -482,7 +484,7 @@ public:
               file.ignore();
               auto *loot = registry.GetComponent<LootComponent>(target);
               if (!loot)
-                loot = &registry.AddComponent(target, LootComponent{});
+                loot = registry.AddComponent(target, LootComponent{});
               loot->drops.clear();
               for (int k = 0; k < itemCount; ++k) {
                 std::string iname, icon;
@@ -0,0 +1,105 @@
+#pragma once
+#include "ECS.h"
+#include "JobSystem.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace PixelsEngine {
+
+// Runs per-frame systems that declare which components they read and write.
+// A system waits only on earlier-registered systems whose access conflicts
+// with its own (write/write or read/write on the same component), so
+// independent systems run concurrently on the job system while conflicting
+// ones keep their registration order.
+class Scheduler {
+public:
+  using SystemFunc = std::function<void(float)>;
+
+  class System {
+  public:
+    // Declaring a component also creates its pool up front, so systems
+    // running in parallel never race on pool creation.
+    template <typename... Ts> System &Reads() {
+      (m_Registry.RegisterComponent<Ts>(), ...);
+      m_Reads |= MakeSignature<Ts...>();
+      return *this;
+    }
+
+    template <typename... Ts> System &Writes() {
+      (m_Registry.RegisterComponent<Ts>(), ...);
+      m_Writes |= MakeSignature<Ts...>();
+      return *this;
+    }
+
+    bool ConflictsWith(const System &other) const {
+      return (m_Writes & (other.m_Reads | other.m_Writes)).any() ||
+             (m_Reads & other.m_Writes).any();
+    }
+
+    const std::string &GetName() const { return m_Name; }
+
+  private:
+    friend class Scheduler;
+    System(Registry &registry, std::string name, SystemFunc func)
+        : m_Registry(registry), m_Name(std::move(name)),
+          m_Func(std::move(func)) {}
+
+    Registry &m_Registry;
+    std::string m_Name;
+    SystemFunc m_Func;
+    Signature m_Reads;
+    Signature m_Writes;
+    std::vector<size_t> m_DependsOn;
+  };
+
+  Scheduler(Registry &registry, JobSystem &jobs)
+      : m_Registry(registry), m_Jobs(jobs) {}
+
+  System &AddSystem(std::string name, SystemFunc func) {
+    m_Systems.push_back(std::unique_ptr<System>(
+        new System(m_Registry, std::move(name), std::move(func))));
+    m_Dirty = true;
+    return *m_Systems.back();
+  }
+
+  void Run(float deltaTime) {
+    if (m_Dirty)
+      BuildGraph();
+
+    std::vector<JobCounter> done(m_Systems.size());
+    for (size_t i = 0; i < m_Systems.size(); ++i) {
+      std::vector<JobCounter *> deps;
+      for (size_t dep : m_Systems[i]->m_DependsOn)
+        deps.push_back(&done[dep]);
+      System *system = m_Systems[i].get();
+      m_Jobs.Run([system, deltaTime]() { system->m_Func(deltaTime); },
+                 &done[i], deps);
+    }
+    for (auto &counter : done)
+      m_Jobs.Wait(counter);
+  }
+
+private:
+  // Only direct conflicts are recorded; ordering through intermediate
+  // systems follows transitively.
+  void BuildGraph() {
+    for (size_t i = 0; i < m_Systems.size(); ++i) {
+      m_Systems[i]->m_DependsOn.clear();
+      for (size_t j = 0; j < i; ++j) {
+        if (m_Systems[i]->ConflictsWith(*m_Systems[j]))
+          m_Systems[i]->m_DependsOn.push_back(j);
+      }
+    }
+    m_Dirty = false;
+  }
+
+  Registry &m_Registry;
+  JobSystem &m_Jobs;
+  std::vector<std::unique_ptr<System>> m_Systems;
+  bool m_Dirty = false;
+};
+
+} // namespace PixelsEngine
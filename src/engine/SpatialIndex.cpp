@@ -0,0 +1,64 @@
+#include "SpatialIndex.h"
+
+namespace PixelsEngine {
+
+void SpatialIndex::Rebuild(Registry &registry) {
+  m_Cells.clear();
+  m_Entities.clear();
+  registry.View<TransformComponent>().each(
+      [&](Entity entity, TransformComponent &transform) {
+        Insert(entity, transform.x, transform.y);
+      });
+}
+
+void SpatialIndex::Update(Registry &registry) {
+  auto refile = [&](const std::vector<Entity> &changed) {
+    for (Entity entity : changed) {
+      if (auto *transform = registry.GetComponent<TransformComponent>(entity))
+        Insert(entity, transform->x, transform->y);
+      else
+        Remove(entity);
+    }
+  };
+  refile(registry.Added<TransformComponent>());
+  refile(registry.Updated<TransformComponent>());
+
+  // Every transform is filed, so holding more entities than the pool means
+  // some lost theirs; only then is the sweep worth it.
+  if (m_Entities.size() <= registry.View<TransformComponent>().size())
+    return;
+  m_Stale.clear();
+  for (auto &filed : m_Entities)
+    if (!registry.HasComponent<TransformComponent>(filed.first))
+      m_Stale.push_back(filed.first);
+  for (Entity entity : m_Stale)
+    Remove(entity);
+}
+
+void SpatialIndex::Insert(Entity entity, float x, float y) {
+  int64_t key = Key(Cell(x), Cell(y));
+  auto it = m_Entities.find(entity);
+  if (it != m_Entities.end()) {
+    if (it->second == key)
+      return;
+    Remove(entity);
+  }
+  m_Cells[key].push_back(entity);
+  m_Entities.emplace(entity, key);
+}
+
+void SpatialIndex::Remove(Entity entity) {
+  auto it = m_Entities.find(entity);
+  if (it == m_Entities.end())
+    return;
+  auto cell = m_Cells.find(it->second);
+  auto &entities = cell->second;
+  auto slot = std::find(entities.begin(), entities.end(), entity);
+  *slot = entities.back();
+  entities.pop_back();
+  if (entities.empty())
+    m_Cells.erase(cell);
+  m_Entities.erase(it);
+}
+
+} // namespace PixelsEngine
@@ -0,0 +1,188 @@
+#pragma once
+#include "Components.h"
+#include "ECS.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PixelsEngine {
+
+// Uniform grid over every entity with a transform, bucketed by cellSize
+// tiles, so proximity queries touch only the cells they overlap instead of
+// the whole world. Cells are hashed, so parked entities far off the map cost
+// nothing. Kept current from transform change tracking, like OccupancyGrid:
+// positions filed are at most a frame old, while the positions handed to
+// query callbacks are always the live ones. Queries take component filters
+// (entities lacking any are skipped) and must not run while Update or
+// Rebuild does.
+class SpatialIndex {
+public:
+  static constexpr int DEFAULT_CELL_SIZE = 4;
+
+  explicit SpatialIndex(int cellSize = DEFAULT_CELL_SIZE)
+      : m_CellSize(cellSize) {}
+
+  // Files every transform from scratch: at start-up, or after a load or
+  // snapshot restore moved entities without marking their transforms.
+  void Rebuild(Registry &registry);
+  // Re-files transforms added or patched since the last ClearChanges() and
+  // drops entities that lost theirs. Call before Registry::ClearChanges().
+  void Update(Registry &registry);
+
+  void Insert(Entity entity, float x, float y);
+  void Remove(Entity entity);
+  size_t GetSize() const { return m_Entities.size(); }
+
+  // func(entity, transform) for each entity inside the rectangle (inclusive).
+  template <typename... With, typename Func>
+  void QueryRect(Registry &registry, float minX, float minY, float maxX,
+                 float maxY, Func &&func) const {
+    ForEachCandidate<With...>(
+        registry, minX, minY, maxX, maxY,
+        [&](Entity entity, TransformComponent &transform) {
+          if (transform.x >= minX && transform.x <= maxX &&
+              transform.y >= minY && transform.y <= maxY)
+            func(entity, transform);
+        });
+  }
+
+  // func(entity, transform) for each entity within radius of (x, y).
+  template <typename... With, typename Func>
+  void QueryRadius(Registry &registry, float x, float y, float radius,
+                   Func &&func) const {
+    ForEachCandidate<With...>(
+        registry, x - radius, y - radius, x + radius, y + radius,
+        [&](Entity entity, TransformComponent &transform) {
+          float dx = transform.x - x, dy = transform.y - y;
+          if (dx * dx + dy * dy <= radius * radius)
+            func(entity, transform);
+        });
+  }
+
+  // func(entity, transform) for each entity within radius of (x, y) and
+  // inside the cone facing facingDeg (0 = +x, like AIComponent::facingDir)
+  // with total width coneDeg. The apex itself counts as inside.
+  template <typename... With, typename Func>
+  void QueryCone(Registry &registry, float x, float y, float radius,
+                 float facingDeg, float coneDeg, Func &&func) const {
+    const float toDegrees = 180.0f / 3.14159265f;
+    QueryRadius<With...>(
+        registry, x, y, radius,
+        [&](Entity entity, TransformComponent &transform) {
+          float dx = transform.x - x, dy = transform.y - y;
+          if (dx != 0.0f || dy != 0.0f) {
+            float diff = std::abs(std::atan2(dy, dx) * toDegrees - facingDeg);
+            diff = std::fmod(diff, 360.0f);
+            if (diff > 180.0f)
+              diff = 360.0f - diff;
+            if (diff > coneDeg / 2.0f)
+              return;
+          }
+          func(entity, transform);
+        });
+  }
+
+  // Up to k entities within maxRadius of (x, y) that accept(entity,
+  // transform) lets through, nearest first. Searches outward ring by ring
+  // and stops once nothing unseen could be closer.
+  template <typename... With, typename Accept>
+  void QueryNearest(Registry &registry, float x, float y, size_t k,
+                    float maxRadius, std::vector<Entity> &out,
+                    Accept &&accept) const {
+    out.clear();
+    if (k == 0)
+      return;
+    thread_local std::vector<std::pair<float, Entity>> found;
+    found.clear();
+    int cx = Cell(x), cy = Cell(y);
+    size_t visited = 0;
+    for (int ring = 0;; ++ring) {
+      // Every entity beyond this ring is at least ring * cellSize away.
+      float reach = (float)ring * m_CellSize;
+      for (int ry = -ring; ry <= ring; ++ry) {
+        for (int rx = -ring; rx <= ring; ++rx) {
+          if (std::max(std::abs(rx), std::abs(ry)) != ring)
+            continue;
+          auto cell = m_Cells.find(Key(cx + rx, cy + ry));
+          if (cell == m_Cells.end())
+            continue;
+          visited += cell->second.size();
+          for (Entity entity : cell->second) {
+            if (!(registry.template HasComponent<With>(entity) && ...))
+              continue;
+            auto *transform = registry.GetComponent<TransformComponent>(entity);
+            if (!transform || !accept(entity, *transform))
+              continue;
+            float dx = transform->x - x, dy = transform->y - y;
+            float dist = std::sqrt(dx * dx + dy * dy);
+            if (dist <= maxRadius)
+              found.push_back({dist, entity});
+          }
+        }
+      }
+      size_t settled = 0;
+      for (auto &candidate : found)
+        settled += candidate.first <= reach;
+      if (settled >= k || reach >= maxRadius || visited >= m_Entities.size())
+        break;
+    }
+    size_t count = std::min(k, found.size());
+    std::partial_sort(found.begin(), found.begin() + count, found.end());
+    for (size_t i = 0; i < count; ++i)
+      out.push_back(found[i].second);
+  }
+  template <typename... With>
+  void QueryNearest(Registry &registry, float x, float y, size_t k,
+                    float maxRadius, std::vector<Entity> &out) const {
+    QueryNearest<With...>(registry, x, y, k, maxRadius, out,
+                          [](Entity, TransformComponent &) { return true; });
+  }
+
+private:
+  int Cell(float v) const { return (int)std::floor(v / m_CellSize); }
+  static int64_t Key(int cx, int cy) {
+    return (int64_t)(((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy);
+  }
+
+  // Every filed entity with the With components in the cells overlapping the
+  // rectangle, with its live transform; the caller applies the exact test.
+  template <typename... With, typename Func>
+  void ForEachCandidate(Registry &registry, float minX, float minY,
+                        float maxX, float maxY, Func &&func) const {
+    auto visit = [&](const std::vector<Entity> &entities) {
+      for (Entity entity : entities) {
+        if (!(registry.template HasComponent<With>(entity) && ...))
+          continue;
+        if (auto *transform = registry.GetComponent<TransformComponent>(entity))
+          func(entity, *transform);
+      }
+    };
+    int cx0 = Cell(minX), cy0 = Cell(minY), cx1 = Cell(maxX), cy1 = Cell(maxY);
+    // A rectangle spanning more cells than are occupied reads them directly.
+    if ((int64_t)(cx1 - cx0 + 1) * (cy1 - cy0 + 1) > (int64_t)m_Cells.size()) {
+      for (auto &cell : m_Cells) {
+        int cx = (int)(cell.first >> 32), cy = (int)(uint32_t)cell.first;
+        if (cx >= cx0 && cx <= cx1 && cy >= cy0 && cy <= cy1)
+          visit(cell.second);
+      }
+      return;
+    }
+    for (int cy = cy0; cy <= cy1; ++cy) {
+      for (int cx = cx0; cx <= cx1; ++cx) {
+        auto cell = m_Cells.find(Key(cx, cy));
+        if (cell != m_Cells.end())
+          visit(cell->second);
+      }
+    }
+  }
+
+  int m_CellSize;
+  std::unordered_map<int64_t, std::vector<Entity>> m_Cells;
+  std::unordered_map<Entity, int64_t> m_Entities; // cell each entity is in
+  std::vector<Entity> m_Stale;
+};
+
+} // namespace PixelsEngine
@@ -0,0 +1,72 @@
+#pragma once
+#include "Components.h"
+#include "ECS.h"
+#include <cstdint>
+
+namespace PixelsEngine {
+
+// Z-order key of a tile: the bits of x and y interleaved, so tiles that are
+// close on the map usually get close keys.
+inline uint32_t MortonKey(uint16_t x, uint16_t y) {
+  auto spread = [](uint32_t v) {
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+  };
+  return spread(x) | (spread(y) << 1);
+}
+
+// Off-map positions (e.g. parked entities at -1000) clamp to the edge.
+inline uint32_t MortonKey(const TransformComponent &transform) {
+  auto tile = [](float v) {
+    return (uint16_t)(v <= 0.0f ? 0 : (v >= 65535.0f ? 65535 : (int)v));
+  };
+  return MortonKey(tile(transform.x), tile(transform.y));
+}
+
+// Keeps the transform pool, and the Grouped pools iterated alongside it, in
+// Morton order so neighbourhood loops and the render pass walk memory mostly
+// front to back. Movement is counted through change tracking, so transforms
+// must be tracked; the pools are re-sorted once enough entities have moved
+// or after maxFrames frames with any movement at all.
+template <typename... Grouped> class SpatialSorter {
+public:
+  explicit SpatialSorter(float movedFraction = 0.25f, int maxFrames = 120)
+      : m_MovedFraction(movedFraction), m_MaxFrames(maxFrames) {}
+
+  // Call once per frame, before Registry::ClearChanges() and outside
+  // Scheduler::Run(). Returns true when it sorted.
+  bool Update(Registry &registry) {
+    m_Moved += registry.Updated<TransformComponent>().size() +
+               registry.Added<TransformComponent>().size();
+    ++m_Frames;
+
+    size_t count = registry.View<TransformComponent>().size();
+    bool enoughMoved = m_Moved > 0 && m_Moved >= count * m_MovedFraction;
+    bool due = m_Moved > 0 && m_Frames >= m_MaxFrames;
+    if (!enoughMoved && !due)
+      return false;
+    Sort(registry);
+    return true;
+  }
+
+  void Sort(Registry &registry) {
+    registry.Sort<TransformComponent>(
+        [](const TransformComponent &a, const TransformComponent &b) {
+          return MortonKey(a) < MortonKey(b);
+        });
+    (registry.SortAs<Grouped, TransformComponent>(), ...);
+    m_Moved = 0;
+    m_Frames = 0;
+  }
+
+private:
+  float m_MovedFraction;
+  int m_MaxFrames;
+  size_t m_Moved = 0;
+  int m_Frames = 0;
+};
+
+} // namespace PixelsEngine
@@ -13,6 +13,10 @@ Tilemap::Tilemap(SDL_Renderer *renderer, const std::string &texturePath,
   m_MapData.resize(mapWidth * mapHeight, 0);
   m_VisibilityMap.resize(mapWidth * mapHeight,
                          VisibilityState::Hidden); // Default Hidden
+  m_RegionsX = (mapWidth + REGION_SIZE - 1) / REGION_SIZE;
+  m_RegionsY = (mapHeight + REGION_SIZE - 1) / REGION_SIZE;
+  m_RegionRevisions.resize(m_RegionsX * m_RegionsY, 0);
+  m_AreaParent.resize(mapWidth * mapHeight, -1);
 }
 
 void Tilemap::UpdateVisibility(int centerX, int centerY, int radius) {
@@ -79,8 +83,81 @@ void Tilemap::LoadFog(const std::vector<int> &fogData) {
 
 void Tilemap::SetTile(int x, int y, int tileIndex) {
   if (x >= 0 && x < m_MapWidth && y >= 0 && y < m_MapHeight) {
+    bool wasWalkable = IsWalkable(x, y);
     m_MapData[y * m_MapWidth + x] = tileIndex;
+    if (IsWalkable(x, y) != wasWalkable) {
+      ++m_RegionRevisions[(y / REGION_SIZE) * m_RegionsX + x / REGION_SIZE];
+      ++m_Revision;
+      if (wasWalkable) {
+        m_AreasDirty = true;
+      } else if (!m_AreasDirty) {
+        m_AreaParent[y * m_MapWidth + x] = y * m_MapWidth + x;
+        MergeWithNeighbours(x, y);
+      }
+    }
+  }
+}
+
+int Tilemap::GetArea(int x, int y) const {
+  if (!IsWalkable(x, y))
+    return -1;
+  if (m_AreasDirty)
+    RebuildAreas();
+  return FindArea(y * m_MapWidth + x);
+}
+
+int Tilemap::FindArea(int tile) const {
+  // Read-only, so lookups may share the labels; merges keep chains short.
+  while (m_AreaParent[tile] != tile)
+    tile = m_AreaParent[tile];
+  return tile;
+}
+
+int Tilemap::CompressArea(int tile) const {
+  // Path halving keeps later lookups close to O(1).
+  while (m_AreaParent[tile] != tile) {
+    m_AreaParent[tile] = m_AreaParent[m_AreaParent[tile]];
+    tile = m_AreaParent[tile];
+  }
+  return tile;
+}
+
+void Tilemap::MergeAreas(int a, int b) const {
+  a = CompressArea(a);
+  b = CompressArea(b);
+  if (a != b)
+    m_AreaParent[a] = b;
+}
+
+void Tilemap::MergeWithNeighbours(int x, int y) const {
+  for (int dy = -1; dy <= 1; ++dy)
+    for (int dx = -1; dx <= 1; ++dx)
+      if ((dx != 0 || dy != 0) && IsWalkable(x + dx, y + dy))
+        MergeAreas(y * m_MapWidth + x, (y + dy) * m_MapWidth + x + dx);
+}
+
+void Tilemap::RebuildAreas() const {
+  for (int y = 0; y < m_MapHeight; ++y) {
+    for (int x = 0; x < m_MapWidth; ++x) {
+      int tile = y * m_MapWidth + x;
+      if (!IsWalkable(x, y)) {
+        m_AreaParent[tile] = -1;
+        continue;
+      }
+      m_AreaParent[tile] = tile;
+      // Only the neighbours already labelled: west and the row above.
+      static const int dx[] = {-1, -1, 0, 1};
+      static const int dy[] = {0, -1, -1, -1};
+      for (int i = 0; i < 4; ++i)
+        if (IsWalkable(x + dx[i], y + dy[i]))
+          MergeAreas(tile, (y + dy[i]) * m_MapWidth + x + dx[i]);
+    }
   }
+  // Point every tile straight at its root; lookups do not compress.
+  for (int tile = 0; tile < (int)m_AreaParent.size(); ++tile)
+    if (m_AreaParent[tile] >= 0)
+      m_AreaParent[tile] = CompressArea(tile);
+  m_AreasDirty = false;
 }
 
 int Tilemap::GetTile(int x, int y) const {
@@ -1,6 +1,7 @@
 #pragma once
 #include "Camera.h"
 #include "Texture.h"
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -38,6 +39,26 @@ public:
   int GetWidth() const { return m_MapWidth; }
   int GetHeight() const { return m_MapHeight; }
 
+  // Walkability revisions, per REGION_SIZE square and for the whole map.
+  // SetTile bumps them only when a tile's walkability actually changes, so
+  // path caches and hierarchical graphs can rebuild just what went stale.
+  static constexpr int REGION_SIZE = 16;
+  int GetRegionsX() const { return m_RegionsX; }
+  int GetRegionsY() const { return m_RegionsY; }
+  uint32_t GetRegionRevision(int regionX, int regionY) const {
+    return m_RegionRevisions[regionY * m_RegionsX + regionX];
+  }
+  uint32_t GetRevision() const { return m_Revision; }
+
+  // Connected walkable area of a tile under Pathfinding's 8-way moves, or -1
+  // when blocked or off the map. Ids are only comparable until the next
+  // SetTile. A tile turning walkable merges areas in place; one turning
+  // blocked may split an area, so the labels are rebuilt on the next query.
+  // Lookups on clean labels only read and may run on several threads; the
+  // rebuild writes, so the first call after a blocking SetTile belongs to
+  // the main thread.
+  int GetArea(int x, int y) const;
+
   // Helper to convert Grid Coords to Screen Coords
   void GridToScreen(float gridX, float gridY, int &screenX, int &screenY) const;
   // Helper to convert Screen Coords to Grid Coords
@@ -45,6 +66,11 @@ public:
 
 private:
   int GetTileHeight(int x, int y) const;
+  int FindArea(int tile) const;
+  int CompressArea(int tile) const;
+  void MergeAreas(int a, int b) const;
+  void MergeWithNeighbours(int x, int y) const;
+  void RebuildAreas() const;
   std::unique_ptr<Texture> m_Tileset;
   int m_TileWidth;
   int m_TileHeight;
@@ -52,6 +78,13 @@ private:
   int m_MapHeight;
   std::vector<int> m_MapData;
   std::vector<VisibilityState> m_VisibilityMap; // Stores fog state
+  int m_RegionsX;
+  int m_RegionsY;
+  std::vector<uint32_t> m_RegionRevisions;
+  uint32_t m_Revision = 0;
+  // Union-find over tiles: parent index, -1 for blocked tiles.
+  mutable std::vector<int> m_AreaParent;
+  mutable bool m_AreasDirty = true;
   SDL_Renderer *m_Renderer;
   Projection m_Projection = Projection::TopDown;
 };
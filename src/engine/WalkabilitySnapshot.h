@@ -0,0 +1,40 @@
+#pragma once
+#include "Tilemap.h"
+#include <cstdint>
+#include <vector>
+
+namespace PixelsEngine {
+
+// Immutable copy of a tilemap's walkability at one revision. Searches on
+// worker threads read this instead of a map the game may be editing; it has
+// the same GetWidth/GetHeight/IsWalkable/GetArea surface, so Pathfinding
+// takes either. Area ids are copied flat, so lookups never mutate.
+class WalkabilitySnapshot {
+public:
+  explicit WalkabilitySnapshot(const Tilemap &map)
+      : m_Width(map.GetWidth()), m_Height(map.GetHeight()),
+        m_Revision(map.GetRevision()),
+        m_Areas((size_t)m_Width * m_Height) {
+    for (int y = 0; y < m_Height; ++y)
+      for (int x = 0; x < m_Width; ++x)
+        m_Areas[(size_t)y * m_Width + x] = map.GetArea(x, y);
+  }
+
+  int GetWidth() const { return m_Width; }
+  int GetHeight() const { return m_Height; }
+  uint32_t GetRevision() const { return m_Revision; }
+  bool IsWalkable(int x, int y) const { return GetArea(x, y) >= 0; }
+  int GetArea(int x, int y) const {
+    if (x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+      return -1;
+    return m_Areas[(size_t)y * m_Width + x];
+  }
+
+private:
+  int m_Width;
+  int m_Height;
+  uint32_t m_Revision;
+  std::vector<int> m_Areas; // -1 where blocked
+};
+
+} // namespace PixelsEngine
@@ -36,19 +36,12 @@ void PixelsGateGame::PerformAttack(PixelsEngine::Entity forcedTarget) {
     }
 
     if (target == PixelsEngine::INVALID_ENTITY) {
-        float minDistance = 3.0f;
-        auto &view = GetRegistry().View<PixelsEngine::StatsComponent>();
-        for (auto &[entity, stats] : view) {
-            if (entity == m_Player || stats.isDead) continue;
-            auto *targetTrans = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(entity);
-            if (targetTrans) {
-                float dist = std::sqrt(std::pow(playerTrans->x - targetTrans->x, 2) + std::pow(playerTrans->y - targetTrans->y, 2));
-                if (dist < minDistance) {
-                    minDistance = dist;
-                    target = entity;
-                }
-            }
-        }
+        std::vector<PixelsEngine::Entity> nearest;
+        m_Spatial.QueryNearest<PixelsEngine::StatsComponent>(GetRegistry(), playerTrans->x, playerTrans->y, 1, 3.0f, nearest,
+            [&](PixelsEngine::Entity entity, PixelsEngine::TransformComponent &) {
+            return entity != m_Player && !GetRegistry().GetComponent<PixelsEngine::StatsComponent>(entity)->isDead;
+        });
+        if (!nearest.empty()) target = nearest[0];
     }
 
     if (target != PixelsEngine::INVALID_ENTITY) {
@@ -123,6 +116,7 @@ void PixelsGateGame::PerformAttack(PixelsEngine::Entity forcedTarget) {
                 if (targetStats->currentHealth <= 0) {
                     targetStats->currentHealth = 0;
                     targetStats->isDead = true;
+                    GetRegistry().Patch<PixelsEngine::StatsComponent>(target);
                     
                     // Quest Trigger
                     auto *interact = GetRegistry().GetComponent<PixelsEngine::InteractionComponent>(target);
@@ -134,7 +128,7 @@ void PixelsGateGame::PerformAttack(PixelsEngine::Entity forcedTarget) {
                     // Loot bag spawning
                     auto *tInv = GetRegistry().GetComponent<PixelsEngine::InventoryComponent>(target);
                     auto *loot = GetRegistry().GetComponent<PixelsEngine::LootComponent>(target);
-                    if (!loot) loot = &GetRegistry().AddComponent(target, PixelsEngine::LootComponent{});
+                    if (!loot) loot = GetRegistry().AddComponent(target, PixelsEngine::LootComponent{});
                     if (tInv) {
                         for (auto &item : tInv->items) loot->drops.push_back(item);
                         tInv->items.clear();
@@ -144,28 +138,25 @@ void PixelsGateGame::PerformAttack(PixelsEngine::Entity forcedTarget) {
                 }
 
                 // Witness logic (Crime)
-                auto *targetTag = GetRegistry().GetComponent<PixelsEngine::TagComponent>(target);
                 auto *targetAI = GetRegistry().GetComponent<PixelsEngine::AIComponent>(target);
-                bool isCrime = (targetTag && (targetTag->tag == PixelsEngine::EntityTag::NPC || targetTag->tag == PixelsEngine::EntityTag::Trader));
+                bool isCrime = GetRegistry().HasTag<PixelsEngine::Tags::NPC>(target) || GetRegistry().HasTag<PixelsEngine::Tags::Trader>(target);
                 if (targetAI && targetAI->isAggressive) isCrime = false;
 
                 if (isCrime) {
-                    auto &aiView = GetRegistry().View<PixelsEngine::AIComponent>();
-                    for (auto &[witness, wai] : aiView) {
-                        if (witness == m_Player || witness == target) continue;
-                        auto *wTrans = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(witness);
-                        if (!wTrans) continue;
-                        float d = std::sqrt(std::pow(playerTrans->x - wTrans->x, 2) + std::pow(playerTrans->y - wTrans->y, 2));
+                    GetRegistry().View<PixelsEngine::AIComponent, PixelsEngine::TransformComponent>().each(
+                        [&](PixelsEngine::Entity witness, PixelsEngine::AIComponent &wai, PixelsEngine::TransformComponent &wTrans) {
+                        if (witness == m_Player || witness == target) return;
+                        float d = std::sqrt(std::pow(playerTrans->x - wTrans.x, 2) + std::pow(playerTrans->y - wTrans.y, 2));
                         if (d <= wai.sightRange) {
                             wai.isAggressive = true;
                             wai.hostileTimer = 30.0f;
-                            SpawnFloatingText(wTrans->x, wTrans->y, "Halt criminal!", {255, 0, 0, 255});
+                            SpawnFloatingText(wTrans.x, wTrans.y, "Halt criminal!", {255, 0, 0, 255});
                             if (m_State == GameState::Combat && !IsInTurnOrder(witness)) {
                                 auto *wStats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(witness);
                                 m_Combat.m_TurnOrder.push_back({witness, PixelsEngine::Dice::Roll(20) + (wStats ? wStats->GetModifier(wStats->dexterity) : 0), false});
                             }
                         }
-                    }
+                    });
                 }
             } else {
                 if (targetTrans) {
@@ -205,6 +196,13 @@ void PixelsGateGame::StartCombat(PixelsEngine::Entity enemy) {
         }
         return;
     }
+    // Cheap: pools are only copied once the fight starts changing them
+    auto encounter = std::make_unique<EncounterSnapshot>();
+    encounter->registry = GetRegistry().Snapshot();
+    encounter->worldFlags = m_WorldFlags;
+    encounter->state = m_State;
+    encounter->enemy = enemy;
+
     m_Combat.m_TurnOrder.clear();
     bool anyEnemy = false;
     auto *pStats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(m_Player);
@@ -221,41 +219,39 @@ void PixelsGateGame::StartCombat(PixelsEngine::Entity enemy) {
     }
 
     auto *pTrans = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(m_Player);
-    auto &view = GetRegistry().View<PixelsEngine::AIComponent>();
-    for (auto &[ent, ai] : view) {
-        if (ent == enemy) continue;
-        auto *t = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(ent);
-        if (t && pTrans) {
-            float dist = std::sqrt(std::pow(t->x - pTrans->x, 2) + std::pow(t->y - pTrans->y, 2));
-            
-            // Enemies
-            if (dist < 15.0f && ai.isAggressive) {
-                auto *eStats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(ent);
-                if (eStats && !eStats->isDead) {
-                    m_Combat.m_TurnOrder.push_back({ent, PixelsEngine::Dice::Roll(20) + eStats->GetModifier(eStats->dexterity), false});
-                    anyEnemy = true;
-                }
+    if (pTrans) m_Spatial.QueryRadius<PixelsEngine::AIComponent>(GetRegistry(), pTrans->x, pTrans->y, 15.0f,
+        [&](PixelsEngine::Entity ent, PixelsEngine::TransformComponent &t) {
+        auto &ai = *GetRegistry().GetComponent<PixelsEngine::AIComponent>(ent);
+        if (ent == enemy) return;
+        float dist = std::sqrt(std::pow(t.x - pTrans->x, 2) + std::pow(t.y - pTrans->y, 2));
+        
+        // Enemies
+        if (dist < 15.0f && ai.isAggressive) {
+            auto *eStats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(ent);
+            if (eStats && !eStats->isDead) {
+                m_Combat.m_TurnOrder.push_back({ent, PixelsEngine::Dice::Roll(20) + eStats->GetModifier(eStats->dexterity), false});
+                anyEnemy = true;
             }
-            
-            // Companions
-            auto *tag = GetRegistry().GetComponent<PixelsEngine::TagComponent>(ent);
-            if (dist < 15.0f && tag && tag->tag == PixelsEngine::EntityTag::Companion) {
-                auto *cStats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(ent);
-                if (cStats && !cStats->isDead) {
-                    // Treat as "Player" side for turn control? Or AI Ally?
-                    // Prompt asked for BG3 style, implying control.
-                    // For now, let's mark isPlayer = true to allow HandleCombatInput to drive them,
-                    // BUT HandleCombatInput needs to know WHICH entity.
-                    // If we mark isPlayer=true, RenderCombatUI shows "YOU".
-                    m_Combat.m_TurnOrder.push_back({ent, PixelsEngine::Dice::Roll(20) + cStats->GetModifier(cStats->dexterity), true});
-                }
+        }
+        
+        // Companions
+        if (dist < 15.0f && GetRegistry().HasTag<PixelsEngine::Tags::Companion>(ent)) {
+            auto *cStats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(ent);
+            if (cStats && !cStats->isDead) {
+                // Treat as "Player" side for turn control? Or AI Ally?
+                // Prompt asked for BG3 style, implying control.
+                // For now, let's mark isPlayer = true to allow HandleCombatInput to drive them,
+                // BUT HandleCombatInput needs to know WHICH entity.
+                // If we mark isPlayer=true, RenderCombatUI shows "YOU".
+                m_Combat.m_TurnOrder.push_back({ent, PixelsEngine::Dice::Roll(20) + cStats->GetModifier(cStats->dexterity), true});
             }
         }
-    }
+    });
 
     if (!anyEnemy) { m_Combat.m_TurnOrder.clear(); return; }
 
     std::sort(m_Combat.m_TurnOrder.begin(), m_Combat.m_TurnOrder.end(), [](const CombatManager::CombatTurn &a, const CombatManager::CombatTurn &b) { return a.initiative > b.initiative; });
+    m_Encounter = std::move(encounter);
     m_State = GameState::Combat;
     m_Combat.m_CurrentTurnIndex = -1;
     NextTurn();
@@ -264,13 +260,43 @@ void PixelsGateGame::StartCombat(PixelsEngine::Entity enemy) {
 void PixelsGateGame::EndCombat() {
     m_State = GameState::Playing;
     m_Combat.m_TurnOrder.clear();
+    m_MoveRange.Clear();
+    m_Encounter.reset();
     SpawnFloatingText(0, 0, "Combat Ended", {0, 255, 0, 255});
 }
 
+void PixelsGateGame::RetryEncounter() {
+    if (!m_Encounter) return;
+    auto encounter = std::move(m_Encounter);
+    // Searches and structural commands were made against the world being
+    // thrown away; their handles may not mean the same entities any more.
+    m_PathRequests.CancelAll();
+    m_AIPathTicket = PixelsEngine::INVALID_TICKET;
+    GetCommands().Clear();
+    GetRegistry().Restore(encounter->registry);
+    m_WorldFlags = encounter->worldFlags;
+    m_Occupancy.Rebuild(GetRegistry(), [this](PixelsEngine::Entity e) { return BlocksTile(e); });
+    m_Spatial.Rebuild(GetRegistry());
+
+    m_Combat.Reset();
+    m_DiceRoll.active = false;
+    m_ContextMenu.isOpen = false;
+    m_FloatingText.m_Texts.clear();
+    m_AIOutput = AIOutput();
+    m_FogMap = nullptr; // Force fog to recompute around the restored player
+    m_State = encounter->state;
+    StartCombat(encounter->enemy);
+}
+
 void PixelsGateGame::NextTurn() {
+    // A search still pending for the last enemy's move is no longer wanted
+    m_PathRequests.Cancel(m_AIPathTicket);
+    m_AIPathTicket = PixelsEngine::INVALID_TICKET;
+
     bool enemiesAlive = false;
     std::vector<int> toRemove;
     for (int i = 0; i < m_Combat.m_TurnOrder.size(); ++i) {
+        if (!GetRegistry().Valid(m_Combat.m_TurnOrder[i].entity)) { toRemove.push_back(i); continue; }
         if (!m_Combat.m_TurnOrder[i].isPlayer) {
             auto *stats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(m_Combat.m_TurnOrder[i].entity);
             if (stats && !stats->isDead) enemiesAlive = true;
@@ -301,9 +327,12 @@ void PixelsGateGame::NextTurn() {
     if (cStats && cStats->isDead) { NextTurn(); return; }
 
     m_Combat.m_ActionsLeft = 1; m_Combat.m_BonusActionsLeft = 1; m_Combat.m_MovementLeft = 5.0f;
+    // Everyone else has moved since the last range was flooded
+    m_MoveRange.Clear();
     if (current.isPlayer) {
         auto *pc = GetRegistry().GetComponent<PixelsEngine::PlayerComponent>(m_Player);
         if (pc) m_Combat.m_MovementLeft = pc->speed;
+        RefreshMoveRange();
         SpawnFloatingText(0, 0, "YOUR TURN", {0, 255, 0, 255});
     } else {
         m_Combat.m_CombatTurnTimer = 1.0f;
@@ -315,6 +344,7 @@ void PixelsGateGame::NextTurn() {
 void PixelsGateGame::UpdateCombat(float deltaTime) {
     if (m_Combat.m_CurrentTurnIndex < 0 || m_Combat.m_CurrentTurnIndex >= m_Combat.m_TurnOrder.size()) return;
     auto &turn = m_Combat.m_TurnOrder[m_Combat.m_CurrentTurnIndex];
+    if (!GetRegistry().Valid(turn.entity)) { NextTurn(); return; }
 
     if (turn.isPlayer) { HandleCombatInput(turn.entity); }
     else {
@@ -330,11 +360,30 @@ void PixelsGateGame::UpdateCombat(float deltaTime) {
             m_Combat.m_CombatTurnTimer -= deltaTime;
             if (m_Combat.m_CombatTurnTimer <= 0.0f) {
                 auto *currentMap = GetCurrentMap();
-                m_CurrentAIPath = PixelsEngine::Pathfinding::FindPath(*currentMap, (int)aiTrans->x, (int)aiTrans->y, (int)pTrans->x, (int)pTrans->y);
-                m_CurrentAIPathIndex = 1;
+                int ax = (int)aiTrans->x, ay = (int)aiTrans->y;
+                // First try to reach a free tile beside the player, stepping
+                // around allies that already stand in the way. The route is
+                // kept tile by tile: smoothing would cut through them again.
+                const PixelsEngine::OccupancyGrid *occupancy = (currentMap == m_Level.get()) ? &m_Occupancy : nullptr;
+                if (!PixelsEngine::CooperativePathfinding::FindPath(*currentMap, nullptr, occupancy, turn.entity, ax, ay,
+                                                                    (int)pTrans->x, (int)pTrans->y, 1, m_CurrentAIPath, 16)) {
+                    // Every enemy turn targets the player, so they share one field
+                    m_PlayerField.SetTarget(*currentMap, (int)pTrans->x, (int)pTrans->y);
+                    // Enemies beyond its reach search on a worker; the turn waits for it
+                    if (m_PlayerField.ExtractPath(ax, ay, m_CurrentAIPath))
+                        PixelsEngine::Pathfinding::SmoothPath(*currentMap, ax, ay, m_CurrentAIPath);
+                    else
+                        m_AIPathTicket = m_PathRequests.Submit(*currentMap, ax, ay, (int)pTrans->x, (int)pTrans->y);
+                }
+                // Waypoints are corners now, so none can be skipped
+                m_CurrentAIPathIndex = 0;
             }
             return;
         }
+        if (m_AIPathTicket != PixelsEngine::INVALID_TICKET) {
+            if (!m_PathRequests.Take(m_AIPathTicket, m_CurrentAIPath)) return;
+            m_AIPathTicket = PixelsEngine::INVALID_TICKET;
+        }
 
         bool moving = false;
         if (m_CurrentAIPathIndex != -1 && m_CurrentAIPathIndex < m_CurrentAIPath.size() && m_Combat.m_MovementLeft > 0.1f) {
@@ -350,6 +399,7 @@ void PixelsGateGame::UpdateCombat(float deltaTime) {
                     if (moveThisFrame > distStep) moveThisFrame = distStep;
                     if (moveThisFrame > m_Combat.m_MovementLeft) moveThisFrame = m_Combat.m_MovementLeft;
                     aiTrans->x += (dx/distStep) * moveThisFrame; aiTrans->y += (dy/distStep) * moveThisFrame;
+                    GetRegistry().Patch<PixelsEngine::TransformComponent>(turn.entity);
                     m_Combat.m_MovementLeft -= moveThisFrame; moving = true;
                     if (anim) anim->Play("Run");
                 }
@@ -420,9 +470,10 @@ void PixelsGateGame::CastSpell(const std::string &spellName, PixelsEngine::Entit
             tx = (float)gx; ty = (float)gy;
         }
 
-        auto hazard = GetRegistry().CreateEntity();
-        GetRegistry().AddComponent(hazard, PixelsEngine::TransformComponent{tx, ty});
-        GetRegistry().AddComponent(hazard, PixelsEngine::HazardComponent{PixelsEngine::HazardComponent::Type::Fire, 8, 5.0f});
+        GetCommands().Create([tx, ty](PixelsEngine::Registry &registry, PixelsEngine::Entity hazard) {
+            registry.AddComponent(hazard, PixelsEngine::TransformComponent{tx, ty});
+            registry.AddComponent(hazard, PixelsEngine::HazardComponent{PixelsEngine::HazardComponent::Type::Fire, 8, 5.0f});
+        });
         
         // If we hit a specific target, make them aggressive
         if (target != PixelsEngine::INVALID_ENTITY) {
@@ -498,6 +549,7 @@ void PixelsGateGame::PerformJump(int targetX, int targetY) {
 
     pTrans->x = (float)targetX;
     pTrans->y = (float)targetY;
+    GetRegistry().Patch<PixelsEngine::TransformComponent>(m_Player);
     PixelsEngine::AudioManager::PlaySound("assets/jump.wav");
     SpawnFloatingText(pTrans->x, pTrans->y, "Jump!", {200, 255, 200, 255});
     m_State = m_ReturnState;
@@ -534,6 +586,7 @@ void PixelsGateGame::PerformDash(int targetX, int targetY) {
 
     pTrans->x = (float)targetX;
     pTrans->y = (float)targetY;
+    GetRegistry().Patch<PixelsEngine::TransformComponent>(m_Player);
     PixelsEngine::AudioManager::PlaySound("assets/jump.wav");
     SpawnFloatingText(pTrans->x, pTrans->y, "Dash!", {255, 255, 255, 255});
     m_State = m_ReturnState;
@@ -580,6 +633,7 @@ void PixelsGateGame::PerformShove(PixelsEngine::Entity target) {
         if (currentMap->IsWalkable(nx, ny)) {
             tTrans->x = (float)nx;
             tTrans->y = (float)ny;
+            GetRegistry().Patch<PixelsEngine::TransformComponent>(target);
             PixelsEngine::AudioManager::PlaySound("assets/jump.wav");
             SpawnFloatingText(tTrans->x, tTrans->y, "Shoved!", {255, 150, 0, 255});
         }
@@ -588,6 +642,52 @@ void PixelsGateGame::PerformShove(PixelsEngine::Entity target) {
     m_State = m_ReturnState;
 }
 
+void PixelsGateGame::RefreshMoveRange() {
+    if (m_Combat.m_CurrentTurnIndex < 0 || m_Combat.m_CurrentTurnIndex >= (int)m_Combat.m_TurnOrder.size()) return;
+    auto &turn = m_Combat.m_TurnOrder[m_Combat.m_CurrentTurnIndex];
+    auto *t = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(turn.entity);
+    auto *currentMap = GetCurrentMap();
+    if (!t || !currentMap) return;
+    int x = (int)t->x, y = (int)t->y;
+    float budget = m_Combat.m_MovementLeft;
+    // Standing still with more movement (a Dash) carries the flood on;
+    // having moved, or spent movement in place, starts it over.
+    if (m_MoveRange.IsFrom(*currentMap, x, y) && budget >= m_MoveRange.GetBudget())
+        m_MoveRange.Extend(budget);
+    else
+        m_MoveRange.Build(*currentMap, x, y, budget, currentMap == m_Level.get() ? &m_Occupancy : nullptr, turn.entity);
+}
+
+void PixelsGateGame::RenderMoveRange(const PixelsEngine::Camera &camera) {
+    if (m_State != GameState::Combat) return;
+    if (m_Combat.m_CurrentTurnIndex < 0 || m_Combat.m_CurrentTurnIndex >= (int)m_Combat.m_TurnOrder.size()) return;
+    auto &turn = m_Combat.m_TurnOrder[m_Combat.m_CurrentTurnIndex];
+    if (!turn.isPlayer) return;
+    // Hidden mid-walk; the range settles again once the step ends
+    auto *pathComp = GetRegistry().GetComponent<PixelsEngine::PathMovementComponent>(turn.entity);
+    if (pathComp && pathComp->isMoving) return;
+    auto *currentMap = GetCurrentMap();
+    if (!currentMap) return;
+    RefreshMoveRange();
+
+    std::vector<SDL_Vertex> verts;
+    verts.reserve(m_MoveRange.GetTiles().size() * 6);
+    SDL_Color color = {80, 160, 255, 50};
+    for (const auto &tile : m_MoveRange.GetTiles()) {
+        int sx, sy;
+        currentMap->GridToScreen((float)tile.first, (float)tile.second, sx, sy);
+        float cx = (float)(sx - camera.x + 16);
+        float cy = (float)(sy - camera.y + 8);
+        SDL_Vertex top = {{cx, cy - 8}, color, {0, 0}}, right = {{cx + 16, cy}, color, {0, 0}};
+        SDL_Vertex bottom = {{cx, cy + 8}, color, {0, 0}}, left = {{cx - 16, cy}, color, {0, 0}};
+        verts.insert(verts.end(), {top, right, bottom, top, bottom, left});
+    }
+    if (verts.empty()) return;
+    SDL_SetRenderDrawBlendMode(GetRenderer(), SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(GetRenderer(), NULL, verts.data(), (int)verts.size(), NULL, 0);
+    SDL_SetRenderDrawBlendMode(GetRenderer(), SDL_BLENDMODE_NONE);
+}
+
 bool PixelsGateGame::IsInTurnOrder(PixelsEngine::Entity entity) {
     for (const auto &turn : m_Combat.m_TurnOrder) if (turn.entity == entity) return true;
     return false;
@@ -614,10 +714,9 @@ void PixelsGateGame::RenderCombatUI() {
         SDL_SetRenderDrawColor(renderer, isCurrent ? 50 : 30, isCurrent ? 150 : 30, isCurrent ? 50 : 30, 255);
         
         // Color override based on faction
-        auto *tag = GetRegistry().GetComponent<PixelsEngine::TagComponent>(turn.entity);
-        if (tag && tag->tag == PixelsEngine::EntityTag::Hostile) {
+        if (GetRegistry().HasTag<PixelsEngine::Tags::Hostile>(turn.entity)) {
              SDL_SetRenderDrawColor(renderer, isCurrent ? 180 : 100, 30, 30, 255); // Red for Enemies
-        } else if (turn.isPlayer || (tag && tag->tag == PixelsEngine::EntityTag::Companion)) {
+        } else if (turn.isPlayer || GetRegistry().HasTag<PixelsEngine::Tags::Companion>(turn.entity)) {
              SDL_SetRenderDrawColor(renderer, isCurrent ? 30 : 20, isCurrent ? 180 : 100, 30, 255); // Green for Allies
         }
 
@@ -661,16 +760,13 @@ void PixelsGateGame::RenderEnemyCones(const PixelsEngine::Camera &camera) {
     auto *currentMap = GetCurrentMap();
     if (!currentMap) return;
 
-    auto &view = GetRegistry().View<PixelsEngine::AIComponent>();
-    for (auto &[entity, ai] : view) {
+    GetRegistry().View<PixelsEngine::AIComponent, PixelsEngine::TransformComponent>().each(
+        [&](PixelsEngine::Entity entity, PixelsEngine::AIComponent &ai, PixelsEngine::TransformComponent &transform) {
         auto *stats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(entity);
-        if (stats && stats->isDead) continue;
-        
-        auto *transform = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(entity);
-        if (!transform) continue;
+        if (stats && stats->isDead) return;
         
         int sx, sy;
-        currentMap->GridToScreen(transform->x, transform->y, sx, sy);
+        currentMap->GridToScreen(transform.x, transform.y, sx, sy);
         float centerX = (float)(sx - camera.x + 16);
         float centerY = (float)(sy - camera.y + 8);
         
@@ -683,8 +779,8 @@ void PixelsGateGame::RenderEnemyCones(const PixelsEngine::Camera &camera) {
         int segments = 15;
         for (int i = 0; i <= segments; ++i) {
             float angle = radDir - radHalf + (i * (2 * radHalf) / (float)segments);
-            float gx = transform->x + std::cos(angle) * ai.sightRange;
-            float gy = transform->y + std::sin(angle) * ai.sightRange;
+            float gx = transform.x + std::cos(angle) * ai.sightRange;
+            float gy = transform.y + std::sin(angle) * ai.sightRange;
             
             int px, py;
             currentMap->GridToScreen(gx, gy, px, py);
@@ -697,6 +793,6 @@ void PixelsGateGame::RenderEnemyCones(const PixelsEngine::Camera &camera) {
             SDL_Vertex tri[3] = {verts[0], verts[i], verts[i+1]};
             SDL_RenderGeometry(GetRenderer(), NULL, tri, 3, NULL, 0);
         }
-    }
+    });
     SDL_SetRenderDrawBlendMode(GetRenderer(), SDL_BLENDMODE_NONE);
 }
\ No newline at end of file
@@ -208,8 +208,35 @@ void PixelsGateGame::CheckWorldInteraction(int mx, int my) {
     auto *pathComp = GetRegistry().GetComponent<PixelsEngine::PathMovementComponent>(m_Player);
     if (pt && pathComp) {
         if (gridX < 0 || gridX >= currentMap->GetWidth() || gridY < 0 || gridY >= currentMap->GetHeight()) return;
-        auto p = PixelsEngine::Pathfinding::FindPath(*currentMap, (int)pt->x, (int)pt->y, gridX, gridY);
-        if (!p.empty()) {
+        // Clicks on water, rocks or sealed-off ground walk to the closest
+        // tile the player can actually reach, instead of searching in vain.
+        if (!PixelsEngine::Pathfinding::NearestReachable(*currentMap, (int)pt->x, (int)pt->y, gridX, gridY, 8, gridX, gridY)) return;
+        // Cross-map clicks go through the cluster graph; short hops, and any
+        // route it misses, use the exact search on a worker. Either way this
+        // click supersedes a search still pending from the last one.
+        m_PathRequests.CancelFor(m_Player);
+        std::vector<std::pair<int, int>> p;
+        // On the player's own combat turn, tiles within this turn's range
+        // already have their route; clicks beyond it still search, and the
+        // walk stops when the movement runs out.
+        bool playerTurn = m_State == GameState::Combat && m_Combat.m_CurrentTurnIndex >= 0 &&
+                          m_Combat.m_CurrentTurnIndex < (int)m_Combat.m_TurnOrder.size() &&
+                          m_Combat.m_TurnOrder[m_Combat.m_CurrentTurnIndex].entity == m_Player;
+        if (playerTurn) {
+            RefreshMoveRange();
+            m_MoveRange.ExtractPath(gridX, gridY, p);
+        }
+        int span = std::max(std::abs(gridX - (int)pt->x), std::abs(gridY - (int)pt->y));
+        if (p.empty() && currentMap == m_Level.get() && m_LevelPaths && span > 2 * PixelsEngine::HierarchicalPathfinder::CLUSTER_SIZE &&
+            !m_PathCache.Find(*currentMap, (int)pt->x, (int)pt->y, gridX, gridY, p)) {
+            m_LevelPaths->Refresh();
+            p = m_LevelPaths->FindPath((int)pt->x, (int)pt->y, gridX, gridY);
+            PixelsEngine::Pathfinding::SmoothPath(*currentMap, (int)pt->x, (int)pt->y, p);
+            if (!p.empty()) m_PathCache.Store(*currentMap, (int)pt->x, (int)pt->y, gridX, gridY, p);
+        }
+        if (p.empty())
+            m_PathRequests.Submit(*currentMap, m_Player, (int)pt->x, (int)pt->y, gridX, gridY);
+        else {
             pathComp->path = p;
             pathComp->currentPathIndex = 0;
             pathComp->isMoving = true;
@@ -283,6 +310,7 @@ void PixelsGateGame::HandleInput() {
             if (m_Combat.m_ActionsLeft > 0) {
                 m_Combat.m_MovementLeft += 5.0f; 
                 m_Combat.m_ActionsLeft--;
+                RefreshMoveRange();
                 if(pTrans) SpawnFloatingText(pTrans->x, pTrans->y, "Dashed!", {255, 255, 0, 255});
             } else if(pTrans) SpawnFloatingText(pTrans->x, pTrans->y, "No Actions!", {255, 0, 0, 255});
         } else if(pTrans) {
@@ -440,6 +468,7 @@ void PixelsGateGame::HandleInput() {
                 float newY = trans->y + dy * pc->speed * 0.016f;
                 if (currentMap->IsWalkable((int)newX, (int)newY)) {
                     trans->x = newX; trans->y = newY;
+                    GetRegistry().Patch<PixelsEngine::TransformComponent>(m_Player);
                 }
             }
         }
@@ -489,9 +518,10 @@ void PixelsGateGame::HandleCreationInput() {
 
 void PixelsGateGame::ResetGame() {
     m_WorldFlags.clear();
+    m_Encounter.reset();
     auto &entities = GetRegistry().View<PixelsEngine::TransformComponent>();
     std::vector<PixelsEngine::Entity> toDestroy;
-    for (auto &[entity, trans] : entities) {
+    for (auto [entity, trans] : entities) {
         toDestroy.push_back(entity);
     }
     for (auto ent : toDestroy) GetRegistry().DestroyEntity(ent);
@@ -499,7 +529,7 @@ void PixelsGateGame::ResetGame() {
     SpawnWorldEntities(); 
 
     auto *trans = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(m_Player);
-    if(trans) { trans->x = 20.0f; trans->y = 20.0f; }
+    if(trans) { trans->x = 20.0f; trans->y = 20.0f; GetRegistry().Patch<PixelsEngine::TransformComponent>(m_Player); }
     
     // Snap Camera
     if (trans) {
@@ -650,8 +680,9 @@ void PixelsGateGame::HandleDialogueInput() {
             SpawnFloatingText(0, 0, "Quest Complete: +400G, +500 XP", {0, 255, 0, 255});
             d->tree->currentNodeId = opt.nextNodeId;
         } else if (opt.action == PixelsEngine::DialogueAction::JoinParty) {
-            auto *tag = GetRegistry().GetComponent<PixelsEngine::TagComponent>(m_DialogueWith);
-            if(tag) tag->tag = PixelsEngine::EntityTag::Companion;
+            GetRegistry().RemoveTag<PixelsEngine::Tags::NPC>(m_DialogueWith);
+            GetRegistry().RemoveTag<PixelsEngine::Tags::CampProp>(m_DialogueWith);
+            GetRegistry().AddTag<PixelsEngine::Tags::Companion>(m_DialogueWith);
             auto *ai = GetRegistry().GetComponent<PixelsEngine::AIComponent>(m_DialogueWith);
             if(ai) { ai->isAggressive = false; ai->sightRange = 10.0f; } 
             
@@ -664,8 +695,6 @@ void PixelsGateGame::HandleDialogueInput() {
             SpawnFloatingText(0, 0, "Companion Joined!", {0, 255, 0, 255});
             d->tree->currentNodeId = opt.nextNodeId;
         } else if (opt.action == PixelsEngine::DialogueAction::Dismiss) {
-            auto *tag = GetRegistry().GetComponent<PixelsEngine::TagComponent>(m_DialogueWith);
-            
             // Clear InParty flag
             if (d) m_WorldFlags[d->tree->currentEntityName + "_InParty"] = false;
 
@@ -683,9 +712,11 @@ void PixelsGateGame::HandleDialogueInput() {
                 } else {
                      t->x = -1000.0f; t->y = -1000.0f;
                 }
+                GetRegistry().Patch<PixelsEngine::TransformComponent>(m_DialogueWith);
             } 
             
-            if(tag) tag->tag = PixelsEngine::EntityTag::CampProp; 
+            GetRegistry().RemoveTag<PixelsEngine::Tags::Companion>(m_DialogueWith);
+            GetRegistry().AddTag<PixelsEngine::Tags::CampProp>(m_DialogueWith);
             
             SpawnFloatingText(0, 0, "Companion returned to camp.", {200, 200, 200, 255});
             d->tree->currentNodeId = opt.nextNodeId;
@@ -882,23 +913,22 @@ void PixelsGateGame::HandleRestMenuInput() {
                 m_FadeTimer = m_FadeDuration;
             } else if (selection == 2) { // Leave Camp
                 auto *t = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(m_Player);
-                if(t) { t->x = m_LastWorldPos.x; t->y = m_LastWorldPos.y; }
-
-                auto &view = GetRegistry().View<PixelsEngine::TransformComponent>();
-                for(auto &[ent, trans] : view) {
-                    if (ent == m_Player) continue;
-                    auto *tag = GetRegistry().GetComponent<PixelsEngine::TagComponent>(ent);
+                if(t) { t->x = m_LastWorldPos.x; t->y = m_LastWorldPos.y; GetRegistry().Patch<PixelsEngine::TransformComponent>(m_Player); }
+
+                GetRegistry().View<PixelsEngine::TransformComponent>(PixelsEngine::With<PixelsEngine::Tags::Companion>{}).each(
+                    [&](PixelsEngine::Entity ent, PixelsEngine::TransformComponent &trans) {
+                    trans.x = m_LastWorldPos.x + 1.0f; 
+                    trans.y = m_LastWorldPos.y;
+                    GetRegistry().Patch<PixelsEngine::TransformComponent>(ent);
+                });
+                GetRegistry().View<PixelsEngine::TransformComponent>(PixelsEngine::With<PixelsEngine::Tags::CampProp>{}).each(
+                    [&](PixelsEngine::Entity ent, PixelsEngine::TransformComponent &trans) {
                     auto *interact = GetRegistry().GetComponent<PixelsEngine::InteractionComponent>(ent);
-                    
-                    if (tag && tag->tag == PixelsEngine::EntityTag::Companion) {
-                        trans.x = m_LastWorldPos.x + 1.0f; 
-                        trans.y = m_LastWorldPos.y;
-                    } else if (tag && tag->tag == PixelsEngine::EntityTag::CampProp) {
-                        if (interact && interact->uniqueId == "npc_son") {
-                             trans.x = -1000.0f; trans.y = -1000.0f;
-                        }
+                    if (interact && interact->uniqueId == "npc_son") {
+                         trans.x = -1000.0f; trans.y = -1000.0f;
+                         GetRegistry().Patch<PixelsEngine::TransformComponent>(ent);
                     }
-                }
+                });
 
                 m_State = GameState::Playing;
                 m_ReturnState = GameState::Playing;
@@ -923,26 +953,27 @@ void PixelsGateGame::HandleRestMenuInput() {
                 if(t) { 
                     m_LastWorldPos.x = t->x; m_LastWorldPos.y = t->y; 
                     t->x = 7.0f; t->y = 7.0f; // Camp Spawn
+                    GetRegistry().Patch<PixelsEngine::TransformComponent>(m_Player);
                 }
 
-                auto &view = GetRegistry().View<PixelsEngine::TransformComponent>();
-                for(auto &[ent, trans] : view) {
-                    if (ent == m_Player) continue;
-                    auto *tag = GetRegistry().GetComponent<PixelsEngine::TagComponent>(ent);
+                GetRegistry().View<PixelsEngine::TransformComponent>(PixelsEngine::With<PixelsEngine::Tags::Companion>{}).each(
+                    [&](PixelsEngine::Entity ent, PixelsEngine::TransformComponent &trans) {
                     auto *interact = GetRegistry().GetComponent<PixelsEngine::InteractionComponent>(ent);
-                    
-                    if (tag && tag->tag == PixelsEngine::EntityTag::Companion) {
-                        if (interact && interact->uniqueId == "npc_son") {
-                            trans.x = 10.0f; trans.y = 5.0f;
-                        } else {
-                            trans.x = 8.0f; trans.y = 8.0f; 
-                        }
-                    } else if (tag && tag->tag == PixelsEngine::EntityTag::CampProp) {
-                        if (interact && interact->uniqueId == "npc_son") {
-                            trans.x = 10.0f; trans.y = 5.0f;
-                        }
+                    if (interact && interact->uniqueId == "npc_son") {
+                        trans.x = 10.0f; trans.y = 5.0f;
+                    } else {
+                        trans.x = 8.0f; trans.y = 8.0f; 
                     }
-                }
+                    GetRegistry().Patch<PixelsEngine::TransformComponent>(ent);
+                });
+                GetRegistry().View<PixelsEngine::TransformComponent>(PixelsEngine::With<PixelsEngine::Tags::CampProp>{}).each(
+                    [&](PixelsEngine::Entity ent, PixelsEngine::TransformComponent &trans) {
+                    auto *interact = GetRegistry().GetComponent<PixelsEngine::InteractionComponent>(ent);
+                    if (interact && interact->uniqueId == "npc_son") {
+                        trans.x = 10.0f; trans.y = 5.0f;
+                        GetRegistry().Patch<PixelsEngine::TransformComponent>(ent);
+                    }
+                });
 
                 m_State = GameState::Camp;
             } else { // Back
@@ -969,6 +1000,7 @@ void PixelsGateGame::HandleCombatInput(PixelsEngine::Entity activeEntity) {
             auto *currentMap = GetCurrentMap();
             if (currentMap && t && currentMap->IsWalkable(t->x + dx*cost, t->y + dy*cost)) {
                 t->x += dx*cost; t->y += dy*cost;
+                GetRegistry().Patch<PixelsEngine::TransformComponent>(activeEntity);
                 m_Combat.m_MovementLeft -= cost;
             }
         }
@@ -1008,9 +1040,11 @@ PixelsEngine::Entity PixelsGateGame::GetEntityAtMouse() {
     PixelsEngine::Entity bestTarget = PixelsEngine::INVALID_ENTITY;
     float bestDist = 1000.0f;
 
-    auto &transforms = GetRegistry().View<PixelsEngine::TransformComponent>();
-    for (auto &[ent, t] : transforms) {
-        if (ent == m_Player) continue;
+    // A 32px screen radius spans at most ~2.8 tiles along the iso diagonal
+    int gx, gy; currentMap->ScreenToGrid(mx + camera.x, my + camera.y, gx, gy);
+    m_Spatial.QueryRadius(GetRegistry(), (float)gx, (float)gy, 4.0f,
+        [&](PixelsEngine::Entity ent, PixelsEngine::TransformComponent &t) {
+        if (ent == m_Player) return;
 
         int sx, sy;
         currentMap->GridToScreen(t.x, t.y, sx, sy);
@@ -1032,7 +1066,7 @@ PixelsEngine::Entity PixelsGateGame::GetEntityAtMouse() {
             bestDist = score;
             bestTarget = ent;
         }
-    }
+    });
     return bestTarget;
 }
 
@@ -1052,14 +1086,21 @@ void PixelsGateGame::HandleOptionsInput() {
 void PixelsGateGame::HandleGameOverInput() {
     int mx, my; PixelsEngine::Input::GetMousePosition(mx, my);
     
+    // "Retry Encounter" leads the list while a pre-combat snapshot exists
+    int offset = m_Encounter ? 1 : 0;
+    int count = 2 + offset;
     int hovered = -1;
     int y = GetWindowHeight()/2;
-    for(int i=0; i<2; ++i) {
+    for(int i=0; i<count; ++i) {
         SDL_Rect btn = {GetWindowWidth()/2 - 100, y - 5, 200, 30};
         if(mx >= btn.x && mx <= btn.x + btn.w && my >= btn.y && my <= btn.y + btn.h) hovered = i;
         y += 50;
     }
-    HandleMenuNavigation(2, [&](int i){ if(i==0) TriggerLoadTransition("savegame.dat"); else m_State=GameState::MainMenu; }, nullptr, hovered);
+    HandleMenuNavigation(count, [&](int i){
+        if(i < offset) RetryEncounter();
+        else if(i == offset) TriggerLoadTransition("savegame.dat");
+        else m_State=GameState::MainMenu;
+    }, nullptr, hovered);
 }
 
 void PixelsGateGame::HandleTargetingInput() {
@@ -12,9 +12,9 @@
 #endif
 
 void PixelsGateGame::UpdateAnimations(float deltaTime) {
-    auto &view = GetRegistry().View<PixelsEngine::AnimationComponent>();
-    for (auto &[entity, anim] : view) {
-        if (!anim.isPlaying || anim.animations.empty()) continue;
+    GetRegistry().View<PixelsEngine::AnimationComponent, PixelsEngine::SpriteComponent>().each(
+        [&](PixelsEngine::Entity, PixelsEngine::AnimationComponent &anim, PixelsEngine::SpriteComponent &sprite) {
+        if (!anim.isPlaying || anim.animations.empty()) return;
 
         anim.timer += deltaTime;
         if (anim.timer >= anim.animations[anim.currentAnimationIndex].frameDuration) {
@@ -30,10 +30,37 @@ void PixelsGateGame::UpdateAnimations(float deltaTime) {
             }
         }
 
-        auto *sprite = GetRegistry().GetComponent<PixelsEngine::SpriteComponent>(entity);
-        if (sprite) {
-            sprite->srcRect = anim.animations[anim.currentAnimationIndex].frames[anim.currentFrameIndex];
-        }
+        sprite.srcRect = anim.animations[anim.currentAnimationIndex].frames[anim.currentFrameIndex];
+    });
+}
+
+bool PixelsGateGame::BlocksTile(PixelsEngine::Entity entity) {
+    auto *stats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(entity);
+    if (!stats || stats->isDead) return false;
+    // The grid covers the main level; camp residents, and the party while it
+    // rests there, stand on the camp map instead
+    if (GetRegistry().HasTag<PixelsEngine::Tags::CampProp>(entity)) return false;
+    bool inCamp = (m_State == GameState::Camp || m_ReturnState == GameState::Camp);
+    return !inCamp || (entity != m_Player && !GetRegistry().HasTag<PixelsEngine::Tags::Companion>(entity));
+}
+
+// Main-thread setup for the AI system, which only reads the flow field and
+// writes nothing shared but its step claims and m_AIOutput.
+void PixelsGateGame::PrepareAI() {
+    auto *pTrans = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(m_Player);
+    if (!pTrans) return;
+    // One field build per player step serves every critter chasing them.
+    if (auto *map = GetCurrentMap()) m_PlayerField.SetTarget(*map, (int)pTrans->x, (int)pTrans->y);
+    m_StepClaims.Clear();
+}
+
+void PixelsGateGame::ApplyAIOutput() {
+    for (auto &text : m_AIOutput.texts) SpawnFloatingText(text.x, text.y, text.text, text.color);
+    m_AIOutput.texts.clear();
+    if (m_AIOutput.combatWith != PixelsEngine::INVALID_ENTITY) {
+        PixelsEngine::Entity with = m_AIOutput.combatWith;
+        m_AIOutput.combatWith = PixelsEngine::INVALID_ENTITY;
+        StartCombat(with);
     }
 }
 
@@ -42,42 +69,76 @@ void PixelsGateGame::UpdateAI(float deltaTime) {
     auto *pStats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(m_Player);
     if (!pTrans || !pStats) return;
 
-    auto &view = GetRegistry().View<PixelsEngine::AIComponent>();
-    for (auto &[entity, ai] : view) {
-        if (m_State == GameState::Combat && IsInTurnOrder(entity)) continue;
-        auto *transform = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(entity);
-        if (!transform) continue;
+    auto *map = GetCurrentMap();
+    // On the main level chasers claim the tile they head for, in update
+    // order, so a pack squeezing through a gap queues instead of stacking.
+    bool crowded = map && map == m_Level.get();
+    int playerTile = crowded ? (int)pTrans->y * map->GetWidth() + (int)pTrans->x : -1;
+    auto stepFree = [&](PixelsEngine::Entity self, int x, int y) {
+        int tile = y * map->GetWidth() + x;
+        if (tile == playerTile) return true;
+        return !m_Occupancy.IsOccupied(x, y, self) && m_StepClaims.IsFree(tile, 1, self);
+    };
+    auto towardPlayer = [&](PixelsEngine::Entity self, const PixelsEngine::TransformComponent &t, float &dx, float &dy) {
+        int tx = (int)t.x, ty = (int)t.y, sx, sy;
+        if (map && m_PlayerField.GetDirection(tx, ty, sx, sy)) {
+            if (crowded && !stepFree(self, tx + sx, ty + sy)) {
+                // Take any free neighbour that still gets closer, else wait
+                float best = m_PlayerField.GetCost(tx, ty);
+                bool found = false;
+                for (int ny = -1; ny <= 1; ++ny) {
+                    for (int nx = -1; nx <= 1; ++nx) {
+                        float cost = m_PlayerField.GetCost(tx + nx, ty + ny);
+                        if ((nx || ny) && cost < best && stepFree(self, tx + nx, ty + ny)) {
+                            best = cost; sx = nx; sy = ny; found = true;
+                        }
+                    }
+                }
+                if (!found) { dx = dy = 0.0f; return; }
+            }
+            if (crowded) m_StepClaims.Reserve(self, (ty + sy) * map->GetWidth() + tx + sx, 1);
+            dx = (float)(tx + sx) - t.x; dy = (float)(ty + sy) - t.y;
+        } else {
+            dx = pTrans->x - t.x; dy = pTrans->y - t.y;
+        }
+    };
+
+    // Wildlife steers by the shared maps; null until their first build lands
+    const PixelsEngine::DijkstraMap *fleeMap = map ? m_GoalMaps.GetFleeMap(m_PlayerGoal, *map) : nullptr;
+    const PixelsEngine::DijkstraMap *waterMap = map ? m_GoalMaps.GetMap(m_WaterGoal, *map) : nullptr;
+    const float grazeRange = 6.0f;
 
-        auto *stats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(entity);
-        if (stats && stats->isDead) continue; // Safety check
+    GetRegistry().View<PixelsEngine::AIComponent, PixelsEngine::TransformComponent, PixelsEngine::StatsComponent>().each(
+        [&](PixelsEngine::Entity entity, PixelsEngine::AIComponent &ai, PixelsEngine::TransformComponent &transform, PixelsEngine::StatsComponent &stats) {
+        if (m_State == GameState::Combat && IsInTurnOrder(entity)) return;
+        if (stats.isDead) return; // Safety check
 
-        auto *tag = GetRegistry().GetComponent<PixelsEngine::TagComponent>(entity);
-        if (tag && tag->tag == PixelsEngine::EntityTag::Companion) {
-            float dist = std::sqrt(std::pow(pTrans->x - transform->x, 2) + std::pow(pTrans->y - transform->y, 2));
+        if (GetRegistry().HasTag<PixelsEngine::Tags::Companion>(entity)) {
+            float dist = std::sqrt(std::pow(pTrans->x - transform.x, 2) + std::pow(pTrans->y - transform.y, 2));
             if (dist > 3.0f) {
-                float dx = pTrans->x - transform->x;
-                float dy = pTrans->y - transform->y;
+                float dx, dy;
+                towardPlayer(entity, transform, dx, dy);
                 float len = std::sqrt(dx*dx + dy*dy);
                 if (len > 0) {
                     float speed = 3.8f;
                     float moveX = (dx / len) * speed * deltaTime;
                     float moveY = (dy / len) * speed * deltaTime;
-                    auto *map = GetCurrentMap();
                     if (map) {
-                        if (map->IsWalkable(transform->x + moveX, transform->y + moveY)) {
-                            transform->x += moveX; transform->y += moveY;
-                        } else if (map->IsWalkable(transform->x + moveX, transform->y)) {
-                            transform->x += moveX;
-                        } else if (map->IsWalkable(transform->x, transform->y + moveY)) {
-                            transform->y += moveY;
+                        if (map->IsWalkable(transform.x + moveX, transform.y + moveY)) {
+                            transform.x += moveX; transform.y += moveY;
+                        } else if (map->IsWalkable(transform.x + moveX, transform.y)) {
+                            transform.x += moveX;
+                        } else if (map->IsWalkable(transform.x, transform.y + moveY)) {
+                            transform.y += moveY;
                         }
                     } else {
-                        transform->x += moveX; transform->y += moveY;
+                        transform.x += moveX; transform.y += moveY;
                     }
                     ai.facingDir = std::atan2(dy, dx) * (180.0f / M_PI);
+                    GetRegistry().Patch<PixelsEngine::TransformComponent>(entity);
                 }
             }
-            continue;
+            return;
         }
 
         if (ai.hostileTimer > 0.0f) {
@@ -85,12 +146,12 @@ void PixelsGateGame::UpdateAI(float deltaTime) {
             if (ai.hostileTimer <= 0.0f) ai.isAggressive = false;
         }
 
-        float dist = std::sqrt(std::pow(pTrans->x - transform->x, 2) + std::pow(pTrans->y - transform->y, 2));
+        float dist = std::sqrt(std::pow(pTrans->x - transform.x, 2) + std::pow(pTrans->y - transform.y, 2));
         
         bool detected = false;
         if (dist <= ai.sightRange) {
-            float dx = pTrans->x - transform->x;
-            float dy = pTrans->y - transform->y;
+            float dx = pTrans->x - transform.x;
+            float dy = pTrans->y - transform.y;
             float angleToPlayer = std::atan2(dy, dx) * (180.0f / M_PI);
             
             float diff = std::abs(ai.facingDir - angleToPlayer);
@@ -105,13 +166,38 @@ void PixelsGateGame::UpdateAI(float deltaTime) {
             }
         }
 
+        // Passive wildlife bolts once it notices the player, and otherwise
+        // wanders back within reach of the river.
+        if (GetRegistry().HasTag<PixelsEngine::Tags::Wildlife>(entity) && !ai.isAggressive) {
+            const PixelsEngine::DijkstraMap *goal = nullptr;
+            float speed = 0.0f;
+            int tx = (int)transform.x, ty = (int)transform.y, sx, sy;
+            // Turning tail hides the player from the cone, so keep running a while
+            if (detected) ai.fleeTimer = 3.0f;
+            else if (ai.fleeTimer > 0.0f) ai.fleeTimer -= deltaTime;
+            if (ai.fleeTimer > 0.0f) { goal = fleeMap; speed = 2.5f; }
+            else if (waterMap && waterMap->GetValue(tx, ty) > grazeRange) { goal = waterMap; speed = 0.8f; }
+            if (goal && goal->GetDownhill(tx, ty, sx, sy)) {
+                float dx = (float)(tx + sx) - transform.x, dy = (float)(ty + sy) - transform.y;
+                float len = std::sqrt(dx*dx + dy*dy);
+                if (len > 0) {
+                    transform.x += (dx/len) * speed * deltaTime;
+                    transform.y += (dy/len) * speed * deltaTime;
+                    GetRegistry().Patch<PixelsEngine::TransformComponent>(entity);
+                    ai.facingDir = std::atan2(dy, dx) * (180.0f / M_PI);
+                }
+            }
+        }
+
         if (ai.isAggressive && detected) {
             if (dist > ai.attackRange) {
-                float dx = pTrans->x - transform->x; float dy = pTrans->y - transform->y;
+                float dx, dy;
+                towardPlayer(entity, transform, dx, dy);
                 float len = std::sqrt(dx*dx + dy*dy);
                 if (len > 0) {
-                    transform->x += (dx/len) * 2.0f * deltaTime;
-                    transform->y += (dy/len) * 2.0f * deltaTime;
+                    transform.x += (dx/len) * 2.0f * deltaTime;
+                    transform.y += (dy/len) * 2.0f * deltaTime;
+                    GetRegistry().Patch<PixelsEngine::TransformComponent>(entity);
                     ai.facingDir = std::atan2(dy, dx) * (180.0f / M_PI);
                 }
             } else {
@@ -120,37 +206,36 @@ void PixelsGateGame::UpdateAI(float deltaTime) {
                     auto *pStats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(m_Player);
                     if (pStats) {
                         pStats->currentHealth -= 2;
-                        SpawnFloatingText(pTrans->x, pTrans->y, "-2", {255,0,0,255});
+                        m_AIOutput.texts.push_back({pTrans->x, pTrans->y, "-2", {255,0,0,255}});
                         ai.attackTimer = ai.attackCooldown;
-                        StartCombat(entity);
+                        m_AIOutput.combatWith = entity;
                     }
                 }
             }
         }
-    }
+    });
 }
 
 void PixelsGateGame::UpdateMovement(float deltaTime) {
-    auto &view = GetRegistry().View<PixelsEngine::PathMovementComponent>();
-    for (auto &[entity, pathComp] : view) {
-        if (!pathComp.isMoving || pathComp.path.empty()) continue;
+    GetRegistry().View<PixelsEngine::PathMovementComponent, PixelsEngine::TransformComponent>().each(
+        [&](PixelsEngine::Entity entity, PixelsEngine::PathMovementComponent &pathComp, PixelsEngine::TransformComponent &trans) {
+        if (!pathComp.isMoving || pathComp.path.empty()) return;
 
-        auto *trans = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(entity);
         auto *pc = GetRegistry().GetComponent<PixelsEngine::PlayerComponent>(entity);
-        if (!trans) continue;
 
         float speed = pc ? pc->speed : 3.0f;
         
         float targetX = (float)pathComp.path[pathComp.currentPathIndex].first;
         float targetY = (float)pathComp.path[pathComp.currentPathIndex].second;
 
-        float dx = targetX - trans->x;
-        float dy = targetY - trans->y;
+        float dx = targetX - trans.x;
+        float dy = targetY - trans.y;
         float dist = std::sqrt(dx*dx + dy*dy);
 
         if (dist < 0.05f) {
-            trans->x = targetX;
-            trans->y = targetY;
+            trans.x = targetX;
+            trans.y = targetY;
+            GetRegistry().Patch<PixelsEngine::TransformComponent>(entity);
             pathComp.currentPathIndex++;
             if (pathComp.currentPathIndex >= pathComp.path.size()) {
                 pathComp.isMoving = false;
@@ -167,15 +252,16 @@ void PixelsGateGame::UpdateMovement(float deltaTime) {
                 if (move <= 0) {
                     pathComp.isMoving = false;
                     pathComp.path.clear();
-                    continue;
+                    return;
                 }
                 m_Combat.m_MovementLeft -= move;
             }
 
-            trans->x += (dx / dist) * move;
-            trans->y += (dy / dist) * move;
+            trans.x += (dx / dist) * move;
+            trans.y += (dy / dist) * move;
+            GetRegistry().Patch<PixelsEngine::TransformComponent>(entity);
         }
-    }
+    });
 }
 
 void PixelsGateGame::UpdateDayNight(float deltaTime) {
@@ -201,16 +287,15 @@ void PixelsGateGame::RenderDayNightCycle() {
         if (tint.a > 100) {
             SDL_SetRenderDrawBlendMode(GetRenderer(), SDL_BLENDMODE_ADD);
             
-            auto &lights = GetRegistry().View<PixelsEngine::LightComponent>();
             auto *currentMap = GetCurrentMap();
             auto &camera = GetCamera();
 
-            for(auto &[entity, light] : lights) {
-                auto *trans = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(entity);
-                if(!trans || !currentMap) continue;
+            GetRegistry().View<PixelsEngine::LightComponent, PixelsEngine::TransformComponent>().each(
+                [&](PixelsEngine::Entity, PixelsEngine::LightComponent &light, PixelsEngine::TransformComponent &trans) {
+                if(!currentMap) return;
 
                 int sx, sy;
-                currentMap->GridToScreen(trans->x, trans->y, sx, sy);
+                currentMap->GridToScreen(trans.x, trans.y, sx, sy);
                 float screenX = (float)(sx - camera.x + 16);
                 float screenY = (float)(sy - camera.y + 16);
 
@@ -235,7 +320,7 @@ void PixelsGateGame::RenderDayNightCycle() {
                     SDL_Vertex tri[3] = {verts[0], verts[i+1], verts[i+2]};
                     SDL_RenderGeometry(GetRenderer(), nullptr, tri, 3, nullptr, 0);
                 }
-            }
+            });
             SDL_SetRenderDrawBlendMode(GetRenderer(), SDL_BLENDMODE_NONE);
         }
     }
@@ -283,17 +368,17 @@ void PixelsGateGame::ResolveDiceRoll() {
         }
     } else if (m_DiceRoll.actionType == PixelsEngine::ContextActionType::Pickpocket) {
         bool seen = false;
-        auto &aiView = GetRegistry().View<PixelsEngine::AIComponent>();
         auto *pTrans = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(m_Player);
         
-        for (auto &[witness, wai] : aiView) {
+        // No creature sees farther than this; each witness still checks its own range and cone
+        m_Spatial.QueryRadius<PixelsEngine::AIComponent>(GetRegistry(), pTrans->x, pTrans->y, 15.0f,
+            [&](PixelsEngine::Entity witness, PixelsEngine::TransformComponent &wTrans) {
+            auto &wai = *GetRegistry().GetComponent<PixelsEngine::AIComponent>(witness);
             auto *wStats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(witness);
-            if (wStats && wStats->isDead) continue;
-            auto *wTrans = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(witness);
-            if (!wTrans) continue;
+            if (wStats && wStats->isDead) return;
 
-            float dx = pTrans->x - wTrans->x;
-            float dy = pTrans->y - wTrans->y;
+            float dx = pTrans->x - wTrans.x;
+            float dy = pTrans->y - wTrans.y;
             float dist = std::sqrt(dx*dx + dy*dy);
             
             if (dist <= wai.sightRange) {
@@ -304,10 +389,10 @@ void PixelsGateGame::ResolveDiceRoll() {
                     seen = true;
                     wai.isAggressive = true;
                     wai.hostileTimer = 30.0f;
-                    SpawnFloatingText(wTrans->x, wTrans->y, "Thief!", {255, 0, 0, 255});
+                    SpawnFloatingText(wTrans.x, wTrans.y, "Thief!", {255, 0, 0, 255});
                 }
             }
-        }
+        });
 
         if (seen) {
             SpawnFloatingText(pTrans->x, pTrans->y, "Caught!", {255, 0, 0, 255});
@@ -363,15 +448,15 @@ void PixelsGateGame::PickupItem(PixelsEngine::Entity entity) {
         inv->AddItem("Gold Orb", 1, PixelsEngine::ItemType::Misc, 0, "assets/gold_orb.png", 500);
         m_WorldFlags["Quest_FetchOrb_Found"] = true; // Found the item flag
         SpawnFloatingText(0, 0, "Picked up Gold Orb", {255, 215, 0, 255});
-        GetRegistry().DestroyEntity(entity);
+        GetCommands().Destroy(entity);
     } 
     else if (interact->uniqueId == "item_key" || interact->uniqueId == "obj_chest_key") {
         inv->AddItem("Chest Key", 1, PixelsEngine::ItemType::Misc, 0, "assets/key.png", 0);
-        GetRegistry().DestroyEntity(entity);
+        GetCommands().Destroy(entity);
     }
     else if (interact->uniqueId == "item_tools") {
         inv->AddItem("Thieves' Tools", 1, PixelsEngine::ItemType::Tool, 0, "assets/thieves_tools.png", 25);
-        GetRegistry().DestroyEntity(entity);
+        GetCommands().Destroy(entity);
     }
 }
 
@@ -498,9 +498,10 @@ void PixelsGateGame::RenderGameOver() {
     SDL_SetRenderDrawBlendMode(GetRenderer(), SDL_BLENDMODE_NONE);
     m_TextRenderer->RenderTextCentered("YOU DIED", GetWindowWidth()/2, GetWindowHeight()/3, {255,0,0,255});
     
-    std::string opts[] = {"Load Last Save", "Quit"};
+    std::vector<std::string> opts = {"Load Last Save", "Quit"};
+    if (m_Encounter) opts.insert(opts.begin(), "Retry Encounter");
     int y = GetWindowHeight()/2;
-    for(int i=0; i<2; ++i) {
+    for(int i=0; i<(int)opts.size(); ++i) {
         SDL_Color c = (m_MenuSelection==i) ? SDL_Color{255,255,0,255} : SDL_Color{255,255,255,255};
         m_TextRenderer->RenderTextCentered(opts[i], GetWindowWidth()/2, y, c);
         y+=50;
@@ -544,7 +545,7 @@ void PixelsGateGame::RenderMapScreen() {
         auto &quests = GetRegistry().View<PixelsEngine::QuestComponent>();
         int qy = p.y + 30;
         int winW = GetWindowWidth(); 
-        for(auto &[e, q] : quests) {
+        for(auto [e, q] : quests) {
             if(q.state > 0) {
                 std::string status = (q.state == 2) ? " (COMPLETED)" : " (ACTIVE)";
                 SDL_Color titleCol = (q.state == 2) ? SDL_Color{100, 255, 100, 255} : SDL_Color{255, 215, 0, 255};
@@ -917,7 +918,7 @@ void PixelsGateGame::RenderOverlays() {
         PixelsEngine::Entity hovered = GetEntityAtMouse();
         
         auto &transforms = GetRegistry().View<PixelsEngine::TransformComponent>();
-        for (auto &[ent, t] : transforms) {
+        for (auto [ent, t] : transforms) {
             if (ent == m_Player) continue;
             
             // Only draw for things that have stats (can be attacked/targeted) or interaction
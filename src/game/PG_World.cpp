@@ -88,47 +88,61 @@ void PixelsGateGame::GenerateMainLevelTerrain() {
     }
 }
 
+void PixelsGateGame::BuildPrefabs() {
+    using namespace PixelsEngine;
+    auto wolfTex = TextureManager::LoadTexture(GetRenderer(), "assets/critters/wolf/wolf-run.png");
+    m_WolfPrefab.Set(TransformComponent{0.0f, 0.0f})
+        .Set(StatsComponent{40, 40, 6, false})
+        .Set(InteractionComponent{"Wolf", "npc_wolf", false, 0.0f})
+        .Tag<Tags::Hostile>()
+        .Tag<Tags::Wildlife>()
+        .Set(AIComponent{10.0f, 1.5f, 2.0f, 0.0f, true})
+        .Set(SpriteComponent{wolfTex, {0, 0, 64, 32}, 32, 24})
+        .Set(LootComponent{{{"Wolf Pelt", "assets/wolf_pelt.png", 1, ItemType::Misc, 0, 50}}});
+
+    auto stagTex = TextureManager::LoadTexture(GetRenderer(), "assets/critters/stag/critter_stag_SE_idle.png");
+    m_StagPrefab.Set(TransformComponent{0.0f, 0.0f})
+        .Set(StatsComponent{30, 30, 2, false})
+        .Tag<Tags::Wildlife>()
+        .Set(AIComponent{8.0f, 1.5f, 2.0f, 0.0f, false}) // Not aggressive
+        .Set(SpriteComponent{stagTex, {0, 0, 41, 43}, 20, 32})
+        .Set(LootComponent{{{"Stag Meat", "assets/stag_meat.png", 1, ItemType::Consumable, 0, 30}}});
+
+    auto badgerTex = TextureManager::LoadTexture(GetRenderer(), "assets/critters/badger/critter_badger_SE_idle.png");
+    m_BadgerPrefab.Set(TransformComponent{0.0f, 0.0f})
+        .Set(StatsComponent{20, 20, 4, false})
+        .Tag<Tags::Hostile>()
+        .Tag<Tags::Wildlife>()
+        .Set(AIComponent{6.0f, 1.2f, 2.0f, 0.0f, true})
+        .Set(SpriteComponent{badgerTex, {0, 0, 32, 22}, 16, 16})
+        .Set(LootComponent{{{"Badger Pelt", "assets/badger_pelt.png", 1, ItemType::Misc, 0, 40}}});
+
+    auto boarTex = TextureManager::LoadTexture(GetRenderer(), "assets/critters/boar/boar_SE_run_strip.png");
+    AnimationComponent boarAnim;
+    boarAnim.AddAnimation("Idle", 0, 0, 41, 25, 1);
+    boarAnim.AddAnimation("Run", 0, 0, 41, 25, 4);
+    boarAnim.Play("Idle");
+    m_BoarPrefab.Set(TransformComponent{0.0f, 0.0f})
+        .Set(StatsComponent{30, 30, 2, false})
+        .Set(InteractionComponent{"Boar", "", false, 0.0f}) // Id is per spawn, see CreateBoar
+        .Tag<Tags::Hostile>()
+        .Tag<Tags::Wildlife>()
+        .Set(AIComponent{8.0f, 1.2f, 2.0f, 0.0f, true})
+        .Set(LootComponent{{{"Boar Meat", "assets/ui/item_boarmeat.png", 1, ItemType::Consumable, 0, 25}}})
+        .Set(SpriteComponent{boarTex, {0, 0, 41, 25}, 20, 20})
+        .Set(boarAnim);
+}
+
 void PixelsGateGame::CreateWolf(float x, float y) {
-    auto wolf = GetRegistry().CreateEntity();
-    GetRegistry().AddComponent(wolf, PixelsEngine::TransformComponent{x, y});
-    GetRegistry().AddComponent(wolf, PixelsEngine::StatsComponent{40, 40, 6, false});
-    GetRegistry().AddComponent(wolf, PixelsEngine::InteractionComponent{"Wolf", "npc_wolf", false, 0.0f});
-    GetRegistry().AddComponent(wolf, PixelsEngine::TagComponent{PixelsEngine::EntityTag::Hostile});
-    GetRegistry().AddComponent(wolf, PixelsEngine::AIComponent{10.0f, 1.5f, 2.0f, 0.0f, true});
-    auto tex = PixelsEngine::TextureManager::LoadTexture(GetRenderer(), "assets/critters/wolf/wolf-run.png");
-    GetRegistry().AddComponent(wolf, PixelsEngine::SpriteComponent{tex, {0, 0, 64, 32}, 32, 24});
-    
-    std::vector<PixelsEngine::Item> drops;
-    drops.push_back({"Wolf Pelt", "assets/wolf_pelt.png", 1, PixelsEngine::ItemType::Misc, 0, 50});
-    GetRegistry().AddComponent(wolf, PixelsEngine::LootComponent{drops});
+    GetRegistry().Instantiate(m_WolfPrefab, std::vector<PixelsEngine::TransformComponent>{{x, y}});
 }
 
 void PixelsGateGame::CreateStag(float x, float y) {
-    auto stag = GetRegistry().CreateEntity();
-    GetRegistry().AddComponent(stag, PixelsEngine::TransformComponent{x, y});
-    GetRegistry().AddComponent(stag, PixelsEngine::StatsComponent{30, 30, 2, false});
-    GetRegistry().AddComponent(stag, PixelsEngine::TagComponent{PixelsEngine::EntityTag::None}); // Passive
-    GetRegistry().AddComponent(stag, PixelsEngine::AIComponent{8.0f, 1.5f, 2.0f, 0.0f, false}); // Not aggressive
-    auto tex = PixelsEngine::TextureManager::LoadTexture(GetRenderer(), "assets/critters/stag/critter_stag_SE_idle.png");
-    GetRegistry().AddComponent(stag, PixelsEngine::SpriteComponent{tex, {0, 0, 41, 43}, 20, 32});
-
-    std::vector<PixelsEngine::Item> drops;
-    drops.push_back({"Stag Meat", "assets/stag_meat.png", 1, PixelsEngine::ItemType::Consumable, 0, 30});
-    GetRegistry().AddComponent(stag, PixelsEngine::LootComponent{drops});
+    GetRegistry().Instantiate(m_StagPrefab, std::vector<PixelsEngine::TransformComponent>{{x, y}});
 }
 
 void PixelsGateGame::CreateBadger(float x, float y) {
-    auto badger = GetRegistry().CreateEntity();
-    GetRegistry().AddComponent(badger, PixelsEngine::TransformComponent{x, y});
-    GetRegistry().AddComponent(badger, PixelsEngine::StatsComponent{20, 20, 4, false});
-    GetRegistry().AddComponent(badger, PixelsEngine::TagComponent{PixelsEngine::EntityTag::Hostile});
-    GetRegistry().AddComponent(badger, PixelsEngine::AIComponent{6.0f, 1.2f, 2.0f, 0.0f, true});
-    auto tex = PixelsEngine::TextureManager::LoadTexture(GetRenderer(), "assets/critters/badger/critter_badger_SE_idle.png");
-    GetRegistry().AddComponent(badger, PixelsEngine::SpriteComponent{tex, {0, 0, 32, 22}, 16, 16});
-
-    std::vector<PixelsEngine::Item> drops;
-    drops.push_back({"Badger Pelt", "assets/badger_pelt.png", 1, PixelsEngine::ItemType::Misc, 0, 40});
-    GetRegistry().AddComponent(badger, PixelsEngine::LootComponent{drops});
+    GetRegistry().Instantiate(m_BadgerPrefab, std::vector<PixelsEngine::TransformComponent>{{x, y}});
 }
 
 void PixelsGateGame::CreateWolfBoss(float x, float y) {
@@ -136,7 +150,8 @@ void PixelsGateGame::CreateWolfBoss(float x, float y) {
     GetRegistry().AddComponent(boss, PixelsEngine::TransformComponent{x, y});
     GetRegistry().AddComponent(boss, PixelsEngine::StatsComponent{150, 150, 12, false});
     GetRegistry().AddComponent(boss, PixelsEngine::InteractionComponent{"Dire Wolf", "boss_wolf", false, 0.0f});
-    GetRegistry().AddComponent(boss, PixelsEngine::TagComponent{PixelsEngine::EntityTag::Hostile});
+    GetRegistry().AddTag<PixelsEngine::Tags::Hostile>(boss);
+    GetRegistry().AddTag<PixelsEngine::Tags::Wildlife>(boss);
     GetRegistry().AddComponent(boss, PixelsEngine::AIComponent{12.0f, 2.0f, 2.0f, 0.0f, true});
     auto tex = PixelsEngine::TextureManager::LoadTexture(GetRenderer(), "assets/critters/wolf/wolf-howl.png");
     // Scale 2.0f
@@ -166,7 +181,7 @@ void PixelsGateGame::CreateDeadManAndSon(float x, float y) {
     auto sTex = PixelsEngine::TextureManager::LoadTexture(GetRenderer(), "assets/npc_trader.png"); // Reusing
     GetRegistry().AddComponent(son, PixelsEngine::SpriteComponent{sTex, {0, 0, 32, 32}, 16, 32});
     GetRegistry().AddComponent(son, PixelsEngine::InteractionComponent{"Grieving Son", "npc_son", false, 0.0f});
-    GetRegistry().AddComponent(son, PixelsEngine::TagComponent{PixelsEngine::EntityTag::NPC});
+    GetRegistry().AddTag<PixelsEngine::Tags::NPC>(son);
     GetRegistry().AddComponent(son, PixelsEngine::StatsComponent{30, 30, 3, false});
     GetRegistry().AddComponent(son, PixelsEngine::AIComponent{10.0f, 1.5f, 2.0f, 0.0f, false});
 
@@ -233,21 +248,9 @@ void PixelsGateGame::CreateDeadManAndSon(float x, float y) {
 }
 
 void PixelsGateGame::CreateBoar(float x, float y) {
-    auto boar = GetRegistry().CreateEntity();
-    GetRegistry().AddComponent(boar, PixelsEngine::TransformComponent{x, y});
-    GetRegistry().AddComponent(boar, PixelsEngine::StatsComponent{30, 30, 2, false});
-    GetRegistry().AddComponent(boar, PixelsEngine::InteractionComponent{"Boar", "npc_boar_" + std::to_string((int)x), false, 0.0f});
-    GetRegistry().AddComponent(boar, PixelsEngine::TagComponent{PixelsEngine::EntityTag::Hostile});
-    GetRegistry().AddComponent(boar, PixelsEngine::AIComponent{8.0f, 1.2f, 2.0f, 0.0f, true});
-    std::vector<PixelsEngine::Item> drops;
-    drops.push_back({"Boar Meat", "assets/ui/item_boarmeat.png", 1, PixelsEngine::ItemType::Consumable, 0, 25});
-    GetRegistry().AddComponent(boar, PixelsEngine::LootComponent{drops});
-    auto tex = PixelsEngine::TextureManager::LoadTexture(GetRenderer(), "assets/critters/boar/boar_SE_run_strip.png");
-    GetRegistry().AddComponent(boar, PixelsEngine::SpriteComponent{tex, {0, 0, 41, 25}, 20, 20});
-    auto &anim = GetRegistry().AddComponent(boar, PixelsEngine::AnimationComponent{});
-    anim.AddAnimation("Idle", 0, 0, 41, 25, 1);
-    anim.AddAnimation("Run", 0, 0, 41, 25, 4);
-    anim.Play("Idle");
+    auto boar = GetRegistry().Instantiate(m_BoarPrefab, std::vector<PixelsEngine::TransformComponent>{{x, y}})[0];
+    // Saves match boars by id, so each needs its own
+    GetRegistry().GetComponent<PixelsEngine::InteractionComponent>(boar)->uniqueId = "npc_boar_" + std::to_string((int)x);
 }
 
 void PixelsGateGame::SpawnWorldEntities() {
@@ -261,13 +264,13 @@ void PixelsGateGame::SpawnWorldEntities() {
     pStats.strength = 10; pStats.dexterity = 10; pStats.constitution = 10;
     pStats.intelligence = 10; pStats.wisdom = 10; pStats.charisma = 10;
     GetRegistry().AddComponent(m_Player, pStats);
-    auto &inv = GetRegistry().AddComponent(m_Player, PixelsEngine::InventoryComponent{});
+    auto &inv = *GetRegistry().AddComponent(m_Player, PixelsEngine::InventoryComponent{});
     inv.AddItem("Potion", 3, PixelsEngine::ItemType::Consumable, 0, "assets/ui/item_potion.png", 50);
     inv.AddItem("Thieves' Tools", 1, PixelsEngine::ItemType::Tool, 0, "assets/thieves_tools.png", 25);
     inv.AddItem("Camp Supplies", 3, PixelsEngine::ItemType::Misc, 0, "assets/ui/item_bread.png", 40, 40); // 3 Packs = 120 supplies
     auto playerTexture = PixelsEngine::TextureManager::LoadTexture(GetRenderer(), "assets/knight.png");
     GetRegistry().AddComponent(m_Player, PixelsEngine::SpriteComponent{playerTexture, {0, 0, 32, 32}, 16, 32});
-    auto &anim = GetRegistry().AddComponent(m_Player, PixelsEngine::AnimationComponent{});
+    auto &anim = *GetRegistry().AddComponent(m_Player, PixelsEngine::AnimationComponent{});
     anim.AddAnimation("Idle", 0, 0, 32, 32, 1);
     anim.AddAnimation("WalkDown", 0, 0, 32, 32, 1);
     anim.AddAnimation("WalkRight", 0, 0, 32, 32, 1);
@@ -298,19 +301,25 @@ void PixelsGateGame::SpawnWorldEntities() {
         return true;
     };
 
-    // Scatter Critters
+    // Scatter Critters (one batch per kind)
+    std::vector<PixelsEngine::TransformComponent> spawns;
     for(int i=0; i<8; ++i) {
         float x = 30.0f + (i*10); float y = 30.0f + (i*5);
-        if(IsValidSpawn(x, y)) CreateWolf(x, y);
+        if(IsValidSpawn(x, y)) spawns.push_back({x, y});
     }
+    GetRegistry().Instantiate(m_WolfPrefab, spawns);
+    spawns.clear();
     for(int i=0; i<10; ++i) {
         float x = 10.0f + (i*8); float y = 50.0f + (i*2);
-        if(IsValidSpawn(x, y)) CreateStag(x, y);
+        if(IsValidSpawn(x, y)) spawns.push_back({x, y});
     }
+    GetRegistry().Instantiate(m_StagPrefab, spawns);
+    spawns.clear();
     for(int i=0; i<6; ++i) {
         float x = 60.0f + (i*5); float y = 20.0f + (i*6);
-        if(IsValidSpawn(x, y)) CreateBadger(x, y);
+        if(IsValidSpawn(x, y)) spawns.push_back({x, y});
     }
+    GetRegistry().Instantiate(m_BadgerPrefab, spawns);
     
     // Scenario & Boss
     CreateDeadManAndSon(50.0f, 60.0f);
@@ -329,7 +338,7 @@ void PixelsGateGame::SpawnWorldEntities() {
     GetRegistry().AddComponent(npc1, PixelsEngine::InteractionComponent{"Innkeeper", "npc_innkeeper", false, 0.0f});
     GetRegistry().AddComponent(npc1, PixelsEngine::StatsComponent{50, 50, 5, false});
     GetRegistry().AddComponent(npc1, PixelsEngine::QuestComponent{"FetchOrb", "The innkeeper lost his lucky Gold Orb. He believes it's somewhere near the rocky cliffs.", 0, "Gold Orb"});
-    GetRegistry().AddComponent(npc1, PixelsEngine::TagComponent{PixelsEngine::EntityTag::Quest});
+    GetRegistry().AddTag<PixelsEngine::Tags::Quest>(npc1);
     GetRegistry().AddComponent(npc1, PixelsEngine::AIComponent{8.0f, 1.5f, 2.0f, 0.0f, false, 0.0f, 90.0f, 90.0f});
 
     PixelsEngine::DialogueTree innTree;
@@ -371,7 +380,7 @@ void PixelsGateGame::SpawnWorldEntities() {
     innTree.nodes["discount_fail"] = df;
 
     GetRegistry().AddComponent(npc1, PixelsEngine::DialogueComponent{std::make_shared<PixelsEngine::DialogueTree>(innTree)});
-    auto &n1Inv = GetRegistry().AddComponent(npc1, PixelsEngine::InventoryComponent{});
+    auto &n1Inv = *GetRegistry().AddComponent(npc1, PixelsEngine::InventoryComponent{});
     n1Inv.AddItem("Coins", 100);
     n1Inv.AddItem("Potion", 1, PixelsEngine::ItemType::Consumable, 0, "assets/ui/item_potion.png", 50);
 
@@ -382,7 +391,7 @@ void PixelsGateGame::SpawnWorldEntities() {
     GetRegistry().AddComponent(npc2, PixelsEngine::InteractionComponent{"Guardian", "npc_guardian", false, 0.0f});
     GetRegistry().AddComponent(npc2, PixelsEngine::StatsComponent{50, 50, 5, false});
     GetRegistry().AddComponent(npc2, PixelsEngine::QuestComponent{"HuntBoars", "The road is dangerous. The guardian needs you to thin out the boar population and bring back some meat.", 0, "Boar Meat"});
-    GetRegistry().AddComponent(npc2, PixelsEngine::TagComponent{PixelsEngine::EntityTag::Quest});
+    GetRegistry().AddTag<PixelsEngine::Tags::Quest>(npc2);
     GetRegistry().AddComponent(npc2, PixelsEngine::AIComponent{8.0f, 1.5f, 2.0f, 0.0f, false, 0.0f, 270.0f, 90.0f});
 
     PixelsEngine::DialogueTree guardTree; guardTree.currentEntityName = "Guardian"; guardTree.currentNodeId = "start";
@@ -405,7 +414,7 @@ void PixelsGateGame::SpawnWorldEntities() {
     guardTree.nodes["g_done"] = gd;
 
     GetRegistry().AddComponent(npc2, PixelsEngine::DialogueComponent{std::make_shared<PixelsEngine::DialogueTree>(guardTree)});
-    auto &n2Inv = GetRegistry().AddComponent(npc2, PixelsEngine::InventoryComponent{});
+    auto &n2Inv = *GetRegistry().AddComponent(npc2, PixelsEngine::InventoryComponent{});
     n2Inv.AddItem("Coins", 50);
     n2Inv.AddItem("Bread", 5, PixelsEngine::ItemType::Consumable, 0, "", 10);
 
@@ -414,7 +423,7 @@ void PixelsGateGame::SpawnWorldEntities() {
     GetRegistry().AddComponent(comp, PixelsEngine::TransformComponent{21.0f, 21.0f});
     GetRegistry().AddComponent(comp, PixelsEngine::SpriteComponent{companionTex, {0, 0, 32, 32}, 16, 32});
     GetRegistry().AddComponent(comp, PixelsEngine::InteractionComponent{"Traveler", "npc_traveler", false, 0.0f});
-    GetRegistry().AddComponent(comp, PixelsEngine::TagComponent{PixelsEngine::EntityTag::NPC});
+    GetRegistry().AddTag<PixelsEngine::Tags::NPC>(comp);
     GetRegistry().AddComponent(comp, PixelsEngine::StatsComponent{80, 80, 8, false});
     GetRegistry().AddComponent(comp, PixelsEngine::AIComponent{10.0f, 1.5f, 2.0f, 0.0f, false});
     PixelsEngine::DialogueTree compTree; compTree.currentEntityName = "Traveler"; compTree.currentNodeId = "start";
@@ -425,7 +434,7 @@ void PixelsGateGame::SpawnWorldEntities() {
     PixelsEngine::DialogueNode ci; ci.id = "c_info"; ci.npcText = "Just a wanderer."; ci.options.push_back(PixelsEngine::DialogueOption("[End]", "end", "None", 0, "", "", PixelsEngine::DialogueAction::EndConversation));
     compTree.nodes["c_info"] = ci;
     GetRegistry().AddComponent(comp, PixelsEngine::DialogueComponent{std::make_shared<PixelsEngine::DialogueTree>(compTree)});
-    auto &cInv = GetRegistry().AddComponent(comp, PixelsEngine::InventoryComponent{});
+    auto &cInv = *GetRegistry().AddComponent(comp, PixelsEngine::InventoryComponent{});
     cInv.AddItem("Coins", 10);
 
     // Trader
@@ -433,7 +442,7 @@ void PixelsGateGame::SpawnWorldEntities() {
     GetRegistry().AddComponent(trader, PixelsEngine::TransformComponent{18.0f, 21.0f});
     GetRegistry().AddComponent(trader, PixelsEngine::SpriteComponent{traderTex, {0, 0, 32, 32}, 16, 32});
     GetRegistry().AddComponent(trader, PixelsEngine::InteractionComponent{"Trader", "npc_trader", false, 0.0f});
-    GetRegistry().AddComponent(trader, PixelsEngine::TagComponent{PixelsEngine::EntityTag::Trader});
+    GetRegistry().AddTag<PixelsEngine::Tags::Trader>(trader);
     GetRegistry().AddComponent(trader, PixelsEngine::StatsComponent{100, 100, 10, false});
     GetRegistry().AddComponent(trader, PixelsEngine::AIComponent{8.0f, 1.5f, 2.0f, 0.0f, false, 0.0f, 0.0f, 120.0f});
     
@@ -443,7 +452,7 @@ void PixelsGateGame::SpawnWorldEntities() {
     tStart.options.push_back(PixelsEngine::DialogueOption("[End]", "end", "None", 0, "", "", PixelsEngine::DialogueAction::EndConversation));
     tradeTree.nodes["start"] = tStart;
     GetRegistry().AddComponent(trader, PixelsEngine::DialogueComponent{std::make_shared<PixelsEngine::DialogueTree>(tradeTree)});
-    auto &tInv = GetRegistry().AddComponent(trader, PixelsEngine::InventoryComponent{});
+    auto &tInv = *GetRegistry().AddComponent(trader, PixelsEngine::InventoryComponent{});
     tInv.AddItem("Sword", 1, PixelsEngine::ItemType::WeaponMelee, 5, "assets/sword.png", 100);
     tInv.AddItem("Bow", 1, PixelsEngine::ItemType::WeaponRanged, 3, "assets/bow.png", 120);
     tInv.AddItem("Armor", 1, PixelsEngine::ItemType::Armor, 2, "assets/armor.png", 150);
@@ -483,14 +492,14 @@ void PixelsGateGame::SpawnWorldEntities() {
     GetRegistry().AddComponent(tent, PixelsEngine::TransformComponent{7.0f, 5.0f});
     auto tentTex = PixelsEngine::TextureManager::LoadTexture(GetRenderer(), "assets/camp_tent.png");
     GetRegistry().AddComponent(tent, PixelsEngine::SpriteComponent{tentTex, {0, 0, 64, 64}, 32, 48});
-    GetRegistry().AddComponent(tent, PixelsEngine::TagComponent{PixelsEngine::EntityTag::CampProp});
+    GetRegistry().AddTag<PixelsEngine::Tags::CampProp>(tent);
 
     // Bedroll (Camp)
     auto bedroll = GetRegistry().CreateEntity();
     GetRegistry().AddComponent(bedroll, PixelsEngine::TransformComponent{8.0f, 6.0f});
     auto bedrollTex = PixelsEngine::TextureManager::LoadTexture(GetRenderer(), "assets/camp_bedroll.png");
     GetRegistry().AddComponent(bedroll, PixelsEngine::SpriteComponent{bedrollTex, {0, 0, 32, 32}, 16, 16});
-    GetRegistry().AddComponent(bedroll, PixelsEngine::TagComponent{PixelsEngine::EntityTag::CampProp});
+    GetRegistry().AddTag<PixelsEngine::Tags::CampProp>(bedroll);
     GetRegistry().AddComponent(bedroll, PixelsEngine::InteractionComponent{"Rest", "camp_bedroll", false, 0.0f});
 
     // Fire (Camp)
@@ -498,21 +507,21 @@ void PixelsGateGame::SpawnWorldEntities() {
     GetRegistry().AddComponent(fire, PixelsEngine::TransformComponent{7.5f, 7.5f});
     auto fireTex = PixelsEngine::TextureManager::LoadTexture(GetRenderer(), "assets/camp_fire_sheet.png");
     GetRegistry().AddComponent(fire, PixelsEngine::SpriteComponent{fireTex, {0, 0, 32, 32}, 16, 24});
-    auto &fireAnim = GetRegistry().AddComponent(fire, PixelsEngine::AnimationComponent{});
+    auto &fireAnim = *GetRegistry().AddComponent(fire, PixelsEngine::AnimationComponent{});
     fireAnim.AddAnimation("Burn", 0, 0, 32, 32, 4, 0.15f);
     fireAnim.Play("Burn");
     GetRegistry().AddComponent(fire, PixelsEngine::LightComponent{5.0f, {255, 200, 100, 255}, true});
-    GetRegistry().AddComponent(fire, PixelsEngine::TagComponent{PixelsEngine::EntityTag::CampProp});
+    GetRegistry().AddTag<PixelsEngine::Tags::CampProp>(fire);
     GetRegistry().AddComponent(fire, PixelsEngine::InteractionComponent{"Rest", "camp_fire", false, 0.0f});
 
     // Son's Camp Spot
     auto sTent = GetRegistry().CreateEntity();
     GetRegistry().AddComponent(sTent, PixelsEngine::TransformComponent{11.0f, 4.0f});
     GetRegistry().AddComponent(sTent, PixelsEngine::SpriteComponent{tentTex, {0, 0, 64, 64}, 32, 48});
-    GetRegistry().AddComponent(sTent, PixelsEngine::TagComponent{PixelsEngine::EntityTag::CampProp});
+    GetRegistry().AddTag<PixelsEngine::Tags::CampProp>(sTent);
 
     auto sBed = GetRegistry().CreateEntity();
     GetRegistry().AddComponent(sBed, PixelsEngine::TransformComponent{11.0f, 5.0f});
     GetRegistry().AddComponent(sBed, PixelsEngine::SpriteComponent{bedrollTex, {0, 0, 32, 32}, 16, 16});
-    GetRegistry().AddComponent(sBed, PixelsEngine::TagComponent{PixelsEngine::EntityTag::CampProp});
+    GetRegistry().AddTag<PixelsEngine::Tags::CampProp>(sBed);
 }
\ No newline at end of file
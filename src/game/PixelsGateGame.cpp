@@ -1,8 +1,10 @@
 #include "PixelsGateGame.h"
 #include "../engine/Dice.h"
 #include "../engine/SaveSystem.h"
+#include "../engine/Tiles.h"
 #include "../engine/Input.h"
 #include "../engine/AudioManager.h"
+#include "../engine/AnimationSystem.h"
 #include <iostream>
 
 PixelsGateGame::PixelsGateGame()
@@ -44,7 +46,49 @@ void PixelsGateGame::OnStart() {
   
   InitCampMap();
   GenerateMainLevelTerrain();
+  m_LevelPaths = std::make_unique<PixelsEngine::HierarchicalPathfinder>(*m_Level);
+  m_LevelPaths->Build(&GetJobs());
+  m_PathRequests.SetCache(&m_PathCache);
+  m_PathRequests.SetSmoothing(true);
+  // Flee maps only need to cover how far a critter can see. The river is
+  // fixed, so its map is built once; critters beyond its reach roam freely.
+  m_PlayerGoal = m_GoalMaps.AddGoal(24.0f, 2, true);
+  m_WaterGoal = m_GoalMaps.AddGoal(24.0f);
+  std::vector<std::pair<int, int>> shore;
+  for (int y = 0; y < m_Level->GetHeight(); ++y) {
+    for (int x = 0; x < m_Level->GetWidth(); ++x) {
+      if (!m_Level->IsWalkable(x, y)) continue;
+      bool onShore = false;
+      for (int dy = -1; dy <= 1; ++dy)
+        for (int dx = -1; dx <= 1; ++dx)
+          onShore = onShore || m_Level->GetTile(x + dx, y + dy) == PixelsEngine::Tiles::WATER;
+      if (onShore) shore.push_back({x, y});
+    }
+  }
+  m_GoalMaps.SetSources(m_WaterGoal, *m_Level, shore);
+  BuildPrefabs();
   SpawnWorldEntities();
+  m_Occupancy.Attach(GetRegistry());
+  m_Occupancy.Resize(m_Level->GetWidth(), m_Level->GetHeight());
+  m_Occupancy.Rebuild(GetRegistry(), [this](PixelsEngine::Entity e) { return BlocksTile(e); });
+  m_Spatial.Rebuild(GetRegistry());
+
+  // Fog of war only recomputes when the player's transform changes
+  GetRegistry().EnableTracking<PixelsEngine::TransformComponent>();
+  // Deaths patch stats so the occupancy grid lets go of the corpse
+  GetRegistry().EnableTracking<PixelsEngine::StatsComponent>();
+
+  // AI and movement both write transforms, so they keep this order;
+  // animation touches neither and runs alongside them.
+  GetScheduler().AddSystem("AI", [this](float dt) {
+      if (m_State != GameState::Combat) UpdateAI(dt);
+  }).Reads<PixelsEngine::Tags::Companion, PixelsEngine::Tags::Wildlife>()
+    .Writes<PixelsEngine::AIComponent, PixelsEngine::TransformComponent, PixelsEngine::StatsComponent>();
+  GetScheduler().AddSystem("Movement", [this](float dt) { UpdateMovement(dt); })
+    .Reads<PixelsEngine::PlayerComponent>()
+    .Writes<PixelsEngine::PathMovementComponent, PixelsEngine::TransformComponent>();
+  GetScheduler().AddSystem("Animation", [this](float dt) { UpdateAnimations(dt); })
+    .Writes<PixelsEngine::AnimationComponent, PixelsEngine::SpriteComponent>();
 }
 
 void PixelsGateGame::OnUpdate(float deltaTime) {
@@ -57,20 +101,30 @@ void PixelsGateGame::OnUpdate(float deltaTime) {
   if (m_State == GameState::Playing) m_ReturnState = GameState::Playing;
 
   if (m_State == GameState::Loading) {
-    if (m_LoadFuture.valid() && m_LoadFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-      m_LoadFuture.get();
+    if (m_LoadJob.IsDone()) {
       m_FadeState = FadeState::FadingIn;
       m_FadeTimer = m_FadeDuration;
       m_State = m_LoadedIsCamp ? GameState::Camp : GameState::Playing;
       
       auto *pStats = GetRegistry().GetComponent<PixelsEngine::StatsComponent>(m_Player);
       if (pStats && pStats->currentHealth > 0) pStats->isDead = false;
+      // The load patched every transform it restored, which the next frame's
+      // updates pick up, but not the stats it read back (deaths, the revive
+      // above), so occupancy refiles from scratch
+      m_Occupancy.Rebuild(GetRegistry(), [this](PixelsEngine::Entity e) { return BlocksTile(e); });
     }
     return;
   }
 
   if (m_SaveMessageTimer > 0.0f) m_SaveMessageTimer -= deltaTime;
 
+  // Close screens whose partner entity was destroyed since it was selected
+  if ((m_State == GameState::Dialogue && !GetRegistry().Valid(m_DialogueWith)) ||
+      (m_State == GameState::Looting && !GetRegistry().Valid(m_LootingEntity)) ||
+      (m_State == GameState::Trading && !GetRegistry().Valid(m_TradingWith))) {
+      m_State = m_ReturnState;
+  }
+
   if (m_DiceRoll.active) {
       if (!m_DiceRoll.resultShown) {
           m_DiceRoll.timer += deltaTime;
@@ -101,37 +155,40 @@ void PixelsGateGame::OnUpdate(float deltaTime) {
       }
   }
 
+  // Started once the hazards are done, since a fight snapshots the world
+  PixelsEngine::Entity hazardCombatWith = PixelsEngine::INVALID_ENTITY;
   auto &hazards = GetRegistry().View<PixelsEngine::HazardComponent>();
-  std::vector<PixelsEngine::Entity> hazardsDestroy;
-  for (auto &[hEnt, haz] : hazards) {
+  for (auto [hEnt, haz] : hazards) {
       haz.duration -= deltaTime;
-      if (haz.duration <= 0.0f) { hazardsDestroy.push_back(hEnt); continue; }
+      if (haz.duration <= 0.0f) { GetCommands().Destroy(hEnt); continue; }
       haz.tickTimer += deltaTime;
       if (haz.tickTimer >= 1.0f) {
           haz.tickTimer = 0.0f;
           auto *hTrans = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(hEnt);
           if (hTrans) {
-              auto &victims = GetRegistry().View<PixelsEngine::StatsComponent>();
-              for (auto &[vEnt, vStats] : victims) {
-                  if (vStats.isDead) continue;
-                  auto *vTrans = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(vEnt);
-                  if (vTrans) {
-                      float d = std::sqrt(std::pow(vTrans->x - hTrans->x, 2) + std::pow(vTrans->y - hTrans->y, 2));
-                      if (d < 1.5f) {
-                          vStats.currentHealth -= haz.damage;
-                          SpawnFloatingText(vTrans->x, vTrans->y, "-" + std::to_string(haz.damage) + " (Fire)", {255, 100, 0, 255});
-                          if (vStats.currentHealth <= 0) vStats.isDead = true;
-                          
-                          if (m_State == GameState::Playing || m_State == GameState::Camp) {
-                              StartCombat(vEnt);
-                          }
+              m_Spatial.QueryRadius<PixelsEngine::StatsComponent>(GetRegistry(), hTrans->x, hTrans->y, 1.5f,
+                  [&](PixelsEngine::Entity vEnt, PixelsEngine::TransformComponent &vTrans) {
+                  auto &vStats = *GetRegistry().GetComponent<PixelsEngine::StatsComponent>(vEnt);
+                  if (vStats.isDead) return;
+                  float d = std::sqrt(std::pow(vTrans.x - hTrans->x, 2) + std::pow(vTrans.y - hTrans->y, 2));
+                  if (d < 1.5f) {
+                      vStats.currentHealth -= haz.damage;
+                      SpawnFloatingText(vTrans.x, vTrans.y, "-" + std::to_string(haz.damage) + " (Fire)", {255, 100, 0, 255});
+                      if (vStats.currentHealth <= 0) {
+                          vStats.isDead = true;
+                          GetRegistry().Patch<PixelsEngine::StatsComponent>(vEnt);
+                      }
+                      
+                      if ((m_State == GameState::Playing || m_State == GameState::Camp) &&
+                          hazardCombatWith == PixelsEngine::INVALID_ENTITY) {
+                          hazardCombatWith = vEnt;
                       }
                   }
-              }
+              });
           }
       }
   }
-  for (auto h : hazardsDestroy) GetRegistry().DestroyEntity(h);
+  if (hazardCombatWith != PixelsEngine::INVALID_ENTITY) StartCombat(hazardCombatWith);
 
   UpdateDayNight(deltaTime);
   m_FloatingText.Update(deltaTime);
@@ -157,12 +214,17 @@ void PixelsGateGame::OnUpdate(float deltaTime) {
               m_State = m_ReturnState;
           } else {
               m_State = GameState::Loading;
-              m_LoadFuture = std::async(std::launch::async, [this]() {
+              // Commands and searches made so far target the world being
+              // replaced; their results would land on loaded entities
+              GetCommands().Clear();
+              m_PathRequests.CancelAll();
+              m_AIPathTicket = PixelsEngine::INVALID_TICKET;
+              GetJobs().RunBackground([this]() {
                   float lx = 0.0f, ly = 0.0f;
                   PixelsEngine::SaveSystem::LoadGame(m_PendingLoadFile, GetRegistry(), m_Player, *m_Level, m_LoadedIsCamp, lx, ly);
                   m_LastWorldPos.x = lx; m_LastWorldPos.y = ly;
                   PixelsEngine::SaveSystem::LoadWorldFlags(m_PendingLoadFile, m_WorldFlags);
-              });
+              }, &m_LoadJob);
           }
           return;
       } else if (m_FadeState == FadeState::FadingIn && m_FadeTimer <= 0.0f) {
@@ -214,11 +276,15 @@ void PixelsGateGame::OnUpdate(float deltaTime) {
           else HandleInput();
 
           // 3. Update Systems
+          if (auto *pt = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(m_Player))
+              if (GetCurrentMap() == m_Level.get())
+                  m_GoalMaps.SetSource(m_PlayerGoal, *m_Level, (int)pt->x, (int)pt->y);
+          m_GoalMaps.Update();
+          m_PathRequests.Update(GetRegistry());
           if (m_State == GameState::Combat) UpdateCombat(deltaTime);
-          else UpdateAI(deltaTime);
-          
-          UpdateMovement(deltaTime);
-          UpdateAnimations(deltaTime);
+          if (m_State != GameState::Combat) PrepareAI();
+          GetScheduler().Run(deltaTime);
+          ApplyAIOutput();
 
           // 4. Update Camera & Visibility (Fog of War)
           auto *pTransTarget = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(m_Player);
@@ -226,7 +292,13 @@ void PixelsGateGame::OnUpdate(float deltaTime) {
               auto *currentMap = GetCurrentMap();
               if (currentMap) {
                   int radius = (m_State == GameState::Camp) ? 15 : 6;
-                  currentMap->UpdateVisibility((int)pTransTarget->x, (int)pTransTarget->y, radius); 
+                  bool playerChanged = GetRegistry().IsUpdated<PixelsEngine::TransformComponent>(m_Player) ||
+                                       GetRegistry().IsAdded<PixelsEngine::TransformComponent>(m_Player);
+                  if (playerChanged || currentMap != m_FogMap || radius != m_FogRadius) {
+                      currentMap->UpdateVisibility((int)pTransTarget->x, (int)pTransTarget->y, radius);
+                      m_FogMap = currentMap;
+                      m_FogRadius = radius;
+                  }
 
                   int screenX, screenY;
                   currentMap->GridToScreen(pTransTarget->x, pTransTarget->y, screenX, screenY);
@@ -235,6 +307,10 @@ void PixelsGateGame::OnUpdate(float deltaTime) {
                   cam.y = screenY - cam.height / 2;
               }
           }
+          m_Occupancy.Update<PixelsEngine::StatsComponent>(GetRegistry(), [this](PixelsEngine::Entity e) { return BlocksTile(e); });
+          m_Spatial.Update(GetRegistry());
+          m_SpatialSort.Update(GetRegistry());
+          GetRegistry().ClearChanges();
           break;
   }
 }
@@ -291,28 +367,27 @@ void PixelsGateGame::OnRender() {
                     renderQueue.push_back({(float)(x + y) + (y * 0.01f), PixelsEngine::INVALID_ENTITY, x, y, true});
         }
 
-        auto &sprites = GetRegistry().View<PixelsEngine::SpriteComponent>();
-        for (auto &[entity, sprite] : sprites) {
-            auto *transform = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(entity);
-            if (transform && currentMap) {
-                bool inCampMode = (m_State == GameState::Camp || m_ReturnState == GameState::Camp);
-                
-                if (inCampMode && entity != m_Player) {
-                    auto *tag = GetRegistry().GetComponent<PixelsEngine::TagComponent>(entity);
-                    bool isCampProp = (tag && tag->tag == PixelsEngine::EntityTag::CampProp);
-                    bool isCompanion = (tag && tag->tag == PixelsEngine::EntityTag::Companion);
-                    if (!isCampProp && !isCompanion) continue;
-                } 
-                else if (!inCampMode && entity != m_Player) {
-                     auto *tag = GetRegistry().GetComponent<PixelsEngine::TagComponent>(entity);
-                     if (tag && tag->tag == PixelsEngine::EntityTag::CampProp) continue;
-                }
-                // Only render if visible (Fog of War)
-                bool isVisible = currentMap->IsVisible((int)transform->x, (int)transform->y);
-                if (entity != m_Player && !IsInTurnOrder(entity) && !isVisible) continue;
-                
-                renderQueue.push_back({transform->x + transform->y + (transform->y * 0.01f) + 0.5f, entity, -1, -1, false});
-            }
+        bool inCampMode = (m_State == GameState::Camp || m_ReturnState == GameState::Camp);
+        auto queueSprite = [&](PixelsEngine::Entity entity, PixelsEngine::SpriteComponent &, PixelsEngine::TransformComponent &transform) {
+            if (!currentMap) return;
+            // Only render if visible (Fog of War)
+            bool isVisible = currentMap->IsVisible((int)transform.x, (int)transform.y);
+            if (entity != m_Player && !IsInTurnOrder(entity) && !isVisible) return;
+            
+            renderQueue.push_back({transform.x + transform.y + (transform.y * 0.01f) + 0.5f, entity, -1, -1, false});
+        };
+        if (inCampMode) {
+            // Camp shows the player, camp props and companions only
+            if (auto *sprite = GetRegistry().GetComponent<PixelsEngine::SpriteComponent>(m_Player))
+                if (auto *transform = GetRegistry().GetComponent<PixelsEngine::TransformComponent>(m_Player))
+                    queueSprite(m_Player, *sprite, *transform);
+            GetRegistry().View<PixelsEngine::SpriteComponent, PixelsEngine::TransformComponent>(
+                PixelsEngine::With<PixelsEngine::Tags::CampProp>{}).each(queueSprite);
+            GetRegistry().View<PixelsEngine::SpriteComponent, PixelsEngine::TransformComponent>(
+                PixelsEngine::With<PixelsEngine::Tags::Companion>{}, PixelsEngine::Without<PixelsEngine::Tags::CampProp>{}).each(queueSprite);
+        } else {
+            GetRegistry().View<PixelsEngine::SpriteComponent, PixelsEngine::TransformComponent>(
+                PixelsEngine::Without<PixelsEngine::Tags::CampProp>{}).each(queueSprite);
         }
 
         std::sort(renderQueue.begin(), renderQueue.end(), [](const Renderable &a, const Renderable &b) {
@@ -360,6 +435,7 @@ void PixelsGateGame::OnRender() {
             }
         }
 
+        RenderMoveRange(camera);
         RenderEnemyCones(camera);
 
         // Floating Text
@@ -403,6 +479,7 @@ void PixelsGateGame::OnRender() {
 
 void PixelsGateGame::TriggerLoadTransition(const std::string &filename) {
     m_PendingLoadFile = filename;
+    m_Encounter.reset();
     m_FadeState = FadeState::FadingOut;
     m_FadeTimer = m_FadeDuration;
 }
\ No newline at end of file
@@ -3,14 +3,22 @@
 #include "../engine/Application.h"
 #include "../engine/Components.h"
 #include "../engine/Config.h"
+#include "../engine/CooperativePathfinding.h"
+#include "../engine/DijkstraMapService.h"
 #include "../engine/ECS.h"
+#include "../engine/FlowField.h"
+#include "../engine/HierarchicalPathfinding.h"
 #include "../engine/Inventory.h"
+#include "../engine/MovementRange.h"
+#include "../engine/OccupancyGrid.h"
+#include "../engine/PathRequestQueue.h"
+#include "../engine/SpatialIndex.h"
+#include "../engine/SpatialSort.h"
 #include "../engine/TextRenderer.h"
 #include "../engine/Texture.h"
 #include "../engine/Tilemap.h"
 #include "../engine/UIComponents.h"
 #include <chrono>
-#include <future>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -87,6 +95,7 @@ protected:
     void OnStart() override;
     void OnUpdate(float deltaTime) override;
     void OnRender() override;
+    bool IsRegistryBusy() const override { return m_State == GameState::Loading; }
 
 public:
     // UI
@@ -145,6 +154,7 @@ public:
     // Combat
     void StartCombat(PixelsEngine::Entity enemy);
     void EndCombat();
+    void RetryEncounter();
     void NextTurn();
     void UpdateCombat(float deltaTime);
     void RenderCombatUI();
@@ -154,13 +164,19 @@ public:
     void PerformJump(int targetX, int targetY);
     void PerformShove(PixelsEngine::Entity target);
     void PerformDash(int targetX, int targetY);
+    // Brings m_MoveRange up to date for the active combatant's position and budget
+    void RefreshMoveRange();
+    void RenderMoveRange(const PixelsEngine::Camera &camera);
     bool IsInTurnOrder(PixelsEngine::Entity entity);
+    // Living creatures take up their tile; other entities can be walked past
+    bool BlocksTile(PixelsEngine::Entity entity);
     PixelsEngine::Entity GetEntityAtMouse();
 
     // World
     void InitCampMap();
     void GenerateMainLevelTerrain();
     void SpawnWorldEntities();
+    void BuildPrefabs();
     void CreateBoar(float x, float y);
     void CreateWolf(float x, float y);
     void CreateStag(float x, float y);
@@ -170,7 +186,9 @@ public:
     void ResetGame(); // NEW Helper
 
     // Systems
+    void PrepareAI();
     void UpdateAI(float deltaTime);
+    void ApplyAIOutput();
     void UpdateMovement(float deltaTime);
     void UpdateAnimations(float deltaTime);
     void UpdateDayNight(float deltaTime);
@@ -215,9 +233,17 @@ private:
 
     std::unique_ptr<PixelsEngine::Tilemap> m_Level;
     std::unique_ptr<PixelsEngine::Tilemap> m_CampLevel;
+    // Long click-to-move routes on the main level; camp is too small to need it
+    std::unique_ptr<PixelsEngine::HierarchicalPathfinder> m_LevelPaths;
     std::unique_ptr<PixelsEngine::TextRenderer> m_TextRenderer;
     
     PixelsEngine::Entity m_Player;
+
+    // Critter templates, built once so spawning skips texture lookups
+    PixelsEngine::Prefab m_WolfPrefab;
+    PixelsEngine::Prefab m_StagPrefab;
+    PixelsEngine::Prefab m_BadgerPrefab;
+    PixelsEngine::Prefab m_BoarPrefab;
     PixelsEngine::Entity m_SelectedNPC = PixelsEngine::INVALID_ENTITY;
 
     PixelsEngine::ContextMenu m_ContextMenu;
@@ -229,6 +255,25 @@ private:
 
     std::vector<std::pair<int, int>> m_CurrentAIPath;
     int m_CurrentAIPathIndex = -1;
+    // Toward the player's tile; every chaser and follower steers along it
+    PixelsEngine::FlowField m_PlayerField{48.0f};
+    // Recent routes, shared by click-to-move and queued searches
+    PixelsEngine::PathCache m_PathCache;
+    // Searches too slow for the frame; delivered before the systems run
+    PixelsEngine::PathRequestQueue m_PathRequests{GetJobs()};
+    PixelsEngine::PathTicket m_AIPathTicket = PixelsEngine::INVALID_TICKET;
+    // Creatures standing on the main level's tiles, kept current every frame
+    PixelsEngine::OccupancyGrid m_Occupancy;
+    // Every positioned entity by grid bucket, for proximity lookups
+    PixelsEngine::SpatialIndex m_Spatial;
+    // Next tiles the real-time chasers have claimed, cleared before each AI update
+    PixelsEngine::ReservationTable m_StepClaims;
+    // Where the active combatant can still walk this turn
+    PixelsEngine::MovementRange m_MoveRange;
+    // Shared distance maps wildlife steers by: away from the player, back to the river
+    PixelsEngine::DijkstraMapService m_GoalMaps{GetJobs()};
+    PixelsEngine::DijkstraMapService::GoalId m_PlayerGoal = -1;
+    PixelsEngine::DijkstraMapService::GoalId m_WaterGoal = -1;
 
     int m_MenuSelection = 0;
     int m_MapTab = 0;
@@ -242,8 +287,31 @@ private:
     std::string m_PendingLoadFile;
     bool m_LoadedIsCamp = false;
     bool m_IsRestFade = false;
-    std::future<void> m_LoadFuture;
+    PixelsEngine::JobCounter m_LoadJob;
     float m_EnvironmentDamageTimer = 0.0f;
+    PixelsEngine::Tilemap *m_FogMap = nullptr;
+    int m_FogRadius = 0;
+    // Pools the AI, combat and render loops walk together with transforms
+    PixelsEngine::SpatialSorter<PixelsEngine::SpriteComponent, PixelsEngine::AIComponent,
+                                PixelsEngine::StatsComponent> m_SpatialSort;
+
+    // What the AI system raises while it runs on a worker: it writes only
+    // here, and the main thread applies it once the systems are done
+    struct AIOutput {
+        struct Text { float x, y; std::string text; SDL_Color color; };
+        std::vector<Text> texts;
+        PixelsEngine::Entity combatWith = PixelsEngine::INVALID_ENTITY;
+    };
+    AIOutput m_AIOutput;
+
+    // World as it stood when the current fight began, for "Retry Encounter"
+    struct EncounterSnapshot {
+        PixelsEngine::RegistrySnapshot registry;
+        std::unordered_map<std::string, bool> worldFlags;
+        GameState state;
+        PixelsEngine::Entity enemy;
+    };
+    std::unique_ptr<EncounterSnapshot> m_Encounter;
 
     int m_DraggingItemIndex = -1;
     float m_LastClickTime = 0.0f;